@@ -0,0 +1,93 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+namespace {
+// What consumers did before: poll a mutex-guarded myn::queue, yielding
+// while it is empty.
+class PollingQueue {
+ public:
+  void push(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(value);
+  }
+  bool pop(int &value) {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!queue_.empty()) {
+          value = queue_.front();
+          queue_.pop();
+          return value >= 0;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  myn::queue<int> queue_;
+};
+}  // namespace
+
+// Round trip through two queues: the time from a push until the sleeping
+// consumer on the other side has woken, popped and answered.
+static void BM_BlockingQueueWakeup(benchmark::State &state) {
+  myn::blocking_queue<int> request;
+  myn::blocking_queue<int> reply;
+  std::thread echo([&] {
+    int value;
+    while (request.pop(value)) reply.push(value);
+  });
+  int value = 0;
+  for (auto _ : state) {
+    request.push(value);
+    reply.pop(value);
+  }
+  request.close();
+  echo.join();
+}
+BENCHMARK(BM_BlockingQueueWakeup)->UseRealTime();
+
+static void BM_PollingQueueWakeup(benchmark::State &state) {
+  PollingQueue request;
+  PollingQueue reply;
+  std::thread echo([&] {
+    int value;
+    while (request.pop(value)) reply.push(value);
+  });
+  int value = 0;
+  for (auto _ : state) {
+    request.push(value);
+    reply.pop(value);
+  }
+  request.push(-1);
+  echo.join();
+}
+BENCHMARK(BM_PollingQueueWakeup)->UseRealTime();
+
+// One producer, one consumer draining up to range(0) elements per wakeup
+// through a queue bounded at 1024.
+static void BM_BlockingQueueBatched(benchmark::State &state) {
+  const size_t batch = state.range(0);
+  const int kItems = 1 << 16;
+  std::vector<int> out(batch);
+  for (auto _ : state) {
+    myn::blocking_queue<int> q(1024);
+    std::thread producer([&q] {
+      for (int i = 0; i < kItems; ++i) q.push(i);
+      q.close();
+    });
+    while (q.pop_bulk(out.data(), batch) != 0) {
+    }
+    producer.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kItems);
+}
+BENCHMARK(BM_BlockingQueueBatched)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->UseRealTime();
@@ -0,0 +1,35 @@
+#include "main.h"
+
+#ifdef __cpp_impl_coroutine
+
+namespace {
+myn::task Produce(myn::channel<int> &ch, int count) {
+  for (int i = 0; i < count; ++i) co_await ch.send(i);
+  ch.close();
+}
+
+myn::task Consume(myn::channel<int> &ch, long &sum) {
+  while (auto value = co_await ch.receive()) sum += *value;
+}
+}  // namespace
+
+// One producer and one consumer coroutine passing range(1) ints through a
+// channel of capacity range(0) on one executor. With a buffer the two sides
+// switch once per buffer-full instead of once per message.
+static void BM_ChannelThroughput(benchmark::State &state) {
+  const int kMessages = static_cast<int>(state.range(1));
+  for (auto _ : state) {
+    myn::executor ex;
+    myn::channel<int> ch(ex, state.range(0));
+    long sum = 0;
+    ex.spawn(Produce(ch, kMessages));
+    ex.spawn(Consume(ch, sum));
+    ex.run();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kMessages);
+}
+BENCHMARK(BM_ChannelThroughput)
+    ->ArgsProduct({{0, 1, 16, 256}, {1 << 16}});
+
+#endif  // __cpp_impl_coroutine
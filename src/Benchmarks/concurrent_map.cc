@@ -0,0 +1,72 @@
+#include <mutex>
+#include <thread>
+
+#include "main.h"
+
+namespace {
+constexpr int kKeys = 1 << 16;
+
+// myn::map behind one mutex: the baseline the skip list has to beat once
+// more than one core is busy.
+class LockedMap {
+ public:
+  bool insert(int key, int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.insert(key, value).second;
+  }
+  bool contains(int key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.contains(key);
+  }
+  size_t erase(int key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!map_.contains(key)) return 0;
+    map_.erase(map_.find({key, 0}));
+    return 1;
+  }
+
+ private:
+  std::mutex mutex_;
+  myn::map<int, int> map_;
+};
+
+template <class Map>
+Map &SharedMap() {
+  static Map *map = [] {
+    Map *m = new Map;
+    for (int key : ShuffledKeys(kKeys)) {
+      if (key % 2 == 0) m->insert(key, key);
+    }
+    return m;
+  }();
+  return *map;
+}
+}  // namespace
+
+// 90% lookups, 5% inserts, 5% erases over a map half full of 64K keys.
+template <class Map>
+static void BM_MixedOps(benchmark::State &state) {
+  Map &map = SharedMap<Map>();
+  std::uint32_t seed = 2654435761u * (state.thread_index() + 1);
+  for (auto _ : state) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    int key = static_cast<int>(seed % kKeys);
+    unsigned op = (seed >> 16) % 100;
+    if (op < 90) {
+      benchmark::DoNotOptimize(map.contains(key));
+    } else if (op < 95) {
+      benchmark::DoNotOptimize(map.insert(key, key));
+    } else {
+      benchmark::DoNotOptimize(map.erase(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_MixedOps, myn::concurrent_map<int, int>)
+    ->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()))
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MixedOps, LockedMap)
+    ->ThreadRange(1, static_cast<int>(std::thread::hardware_concurrency()))
+    ->UseRealTime();
@@ -0,0 +1,54 @@
+#include <mutex>
+#include <thread>
+
+#include "main.h"
+
+namespace {
+// myn::stack behind one mutex, the way the work-sharing code used it.
+class LockedStack {
+ public:
+  void push(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stack_.push(value);
+  }
+  bool try_pop(int &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stack_.empty()) return false;
+    value = stack_.top();
+    stack_.pop();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  myn::stack<int> stack_;
+};
+
+const int kMaxThreads = static_cast<int>(std::thread::hardware_concurrency());
+}  // namespace
+
+// Every thread alternates push and pop on one shared stack.
+template <class Stack>
+static void BM_StackPushPopContended(benchmark::State &state) {
+  static Stack *stack = nullptr;
+  if (state.thread_index() == 0) stack = new Stack;
+  int value = state.thread_index();
+  for (auto _ : state) {
+    stack->push(value);
+    benchmark::DoNotOptimize(stack->try_pop(value));
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  if (state.thread_index() == 0) {
+    delete stack;
+    stack = nullptr;
+  }
+}
+BENCHMARK_TEMPLATE(BM_StackPushPopContended, myn::concurrent_stack<int>)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StackPushPopContended, myn::concurrent_stack<int, 8>)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StackPushPopContended, LockedStack)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
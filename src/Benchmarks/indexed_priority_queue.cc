@@ -0,0 +1,74 @@
+#include <limits>
+#include <random>
+#include <utility>
+
+#include "main.h"
+
+namespace {
+using Graph = std::vector<std::vector<std::pair<size_t, int>>>;
+
+// range(0) nodes with 8 random out-edges each.
+Graph RandomGraph(size_t nodes) {
+  Graph graph(nodes);
+  std::mt19937 rng(42);
+  for (size_t i = 0; i < nodes * 8; ++i) {
+    graph[rng() % nodes].emplace_back(rng() % nodes, 1 + rng() % 1000);
+  }
+  return graph;
+}
+
+const int kInf = std::numeric_limits<int>::max();
+}  // namespace
+
+template <size_t Arity>
+static void BM_DijkstraIndexedHeap(benchmark::State &state) {
+  Graph graph = RandomGraph(state.range(0));
+  std::vector<int> dist(graph.size());
+  for (auto _ : state) {
+    std::fill(dist.begin(), dist.end(), kInf);
+    myn::indexed_priority_queue<int, std::less<int>, Arity> q(graph.size());
+    dist[0] = 0;
+    q.push(0, 0);
+    while (!q.empty()) {
+      size_t u = q.top_id();
+      q.pop();
+      for (auto [v, w] : graph[u]) {
+        if (dist[u] + w >= dist[v]) continue;
+        dist[v] = dist[u] + w;
+        if (q.contains(v)) {
+          q.decrease_key(v, dist[v]);
+        } else {
+          q.push(v, dist[v]);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(dist.data());
+  }
+}
+BENCHMARK_TEMPLATE(BM_DijkstraIndexedHeap, 2)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_DijkstraIndexedHeap, 4)->Range(1 << 10, 1 << 18);
+
+// The old way: a myn::set of (distance, node), erasing and reinserting a
+// node whenever its distance drops.
+static void BM_DijkstraSet(benchmark::State &state) {
+  Graph graph = RandomGraph(state.range(0));
+  std::vector<int> dist(graph.size());
+  for (auto _ : state) {
+    std::fill(dist.begin(), dist.end(), kInf);
+    myn::set<std::pair<int, size_t>> q;
+    dist[0] = 0;
+    q.insert({0, 0});
+    while (!q.empty()) {
+      size_t u = (*q.begin()).second;
+      q.erase(q.begin());
+      for (auto [v, w] : graph[u]) {
+        if (dist[u] + w >= dist[v]) continue;
+        if (dist[v] != kInf) q.erase(q.find({dist[v], v}));
+        dist[v] = dist[u] + w;
+        q.insert({dist[v], v});
+      }
+    }
+    benchmark::DoNotOptimize(dist.data());
+  }
+}
+BENCHMARK(BM_DijkstraSet)->Range(1 << 10, 1 << 18);
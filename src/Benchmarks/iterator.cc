@@ -0,0 +1,58 @@
+#include "main.h"
+
+// Run with and without -DMYN_CHECKED_ITERATORS (make bench / make
+// bench_checked) to see what the checks cost; the release numbers should
+// match the raw pointer loop.
+
+static void BM_RawPointerTraversal(benchmark::State &state) {
+  myn::vector<int> vec(state.range(0));
+  for (auto _ : state) {
+    long sum = 0;
+    for (int *it = vec.data(), *end = it + vec.size(); it != end; ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RawPointerTraversal)->Arg(1 << 20);
+
+static void BM_VectorIteratorTraversal(benchmark::State &state) {
+  myn::vector<int> vec(state.range(0));
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = vec.begin(), end = vec.end(); it != end; ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorIteratorTraversal)->Arg(1 << 20);
+
+static void BM_ListIteratorTraversal(benchmark::State &state) {
+  myn::list<int> l(state.range(0));
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = l.begin(), end = l.end(); it != end; ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ListIteratorTraversal)->Arg(1 << 16);
+
+static void BM_SetIteratorTraversal(benchmark::State &state) {
+  myn::set<int> st;
+  for (int key : ShuffledKeys(state.range(0))) st.insert(key);
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = st.begin(), end = st.end(); it != end; ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetIteratorTraversal)->Arg(1 << 16);
@@ -0,0 +1,98 @@
+#include <list>
+
+#include "main.h"
+
+// Queue-like steady state: the list never grows, so once warm every push
+// should be served from the node pool.
+template <class List>
+static void BM_ListPushPop(benchmark::State &state) {
+  List l;
+  for (long i = 0; i < state.range(0); ++i) l.push_back(static_cast<int>(i));
+  for (auto _ : state) {
+    l.push_back(l.front());
+    l.pop_front();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ListPushPop, myn::list<int>)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_ListPushPop, std::list<int>)->Arg(1024);
+
+template <class List>
+static void BM_ListFillClear(benchmark::State &state) {
+  for (auto _ : state) {
+    List l;
+    for (long i = 0; i < state.range(0); ++i) l.push_back(static_cast<int>(i));
+    l.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ListFillClear, myn::list<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ListFillClear, std::list<int>)->Arg(1 << 16);
+
+template <class List>
+static List ShuffledList(long n) {
+  List l;
+  for (int key : ShuffledKeys(n)) l.push_back(key);
+  return l;
+}
+
+template <class List>
+static void BM_ListSort(benchmark::State &state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    List l = ShuffledList<List>(state.range(0));
+    state.ResumeTiming();
+    l.sort();
+    benchmark::DoNotOptimize(l.front());
+    state.PauseTiming();
+    l.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ListSort, myn::list<int>)
+    ->Arg(10'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ListSort, std::list<int>)
+    ->Arg(10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+// Splices a whole 10M-element list back and forth: O(1) per call.
+template <class List>
+static void BM_ListSplice(benchmark::State &state) {
+  List a = ShuffledList<List>(state.range(0));
+  List b;
+  for (auto _ : state) {
+    b.splice(b.cend(), a);
+    a.splice(a.cend(), b);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_ListSplice, myn::list<int>)->Arg(10'000'000);
+BENCHMARK_TEMPLATE(BM_ListSplice, std::list<int>)->Arg(10'000'000);
+
+template <class List>
+static void BM_ListMerge(benchmark::State &state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    List a;
+    List b;
+    for (long i = 0; i < state.range(0); ++i) {
+      a.push_back(static_cast<int>(2 * i));
+      b.push_back(static_cast<int>(2 * i + 1));
+    }
+    state.ResumeTiming();
+    a.merge(b);
+    benchmark::DoNotOptimize(a.back());
+    state.PauseTiming();
+    a.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ListMerge, myn::list<int>)
+    ->Arg(5'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ListMerge, std::list<int>)
+    ->Arg(5'000'000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,21 @@
+#ifndef SRC_BENCHMARKS_MAIN_H_
+#define SRC_BENCHMARKS_MAIN_H_
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../containers.h"
+
+// 0..n-1 in a fixed pseudo-random order, so tree benchmarks do not build a
+// degenerate chain from sorted input.
+inline std::vector<int> ShuffledKeys(long n) {
+  std::vector<int> keys(n);
+  for (long i = 0; i < n; ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+#endif  // SRC_BENCHMARKS_MAIN_H_
@@ -0,0 +1,57 @@
+#include <mutex>
+#include <thread>
+
+#include "main.h"
+
+namespace {
+// myn::queue behind one mutex, bounded like the ring.
+class LockedQueue {
+ public:
+  explicit LockedQueue(size_t capacity) : capacity_(capacity) {}
+  bool try_push(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() == capacity_) return false;
+    queue_.push(value);
+    return true;
+  }
+  bool try_pop(int &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+    value = queue_.front();
+    queue_.pop();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  myn::queue<int> queue_;
+  size_t capacity_;
+};
+
+const int kMaxThreads = static_cast<int>(std::thread::hardware_concurrency());
+}  // namespace
+
+// Every thread is both producer and consumer: push one, pop one.
+template <class Queue>
+static void BM_MpmcPushPop(benchmark::State &state) {
+  static Queue *queue = nullptr;
+  if (state.thread_index() == 0) queue = new Queue(1024);
+  int value = state.thread_index();
+  for (auto _ : state) {
+    while (!queue->try_push(value)) {
+    }
+    while (!queue->try_pop(value)) {
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  if (state.thread_index() == 0) {
+    delete queue;
+    queue = nullptr;
+  }
+}
+BENCHMARK_TEMPLATE(BM_MpmcPushPop, myn::mpmc_queue<int>)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MpmcPushPop, LockedQueue)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
@@ -0,0 +1,60 @@
+#include <functional>
+#include <queue>
+
+#include "main.h"
+
+namespace {
+template <size_t Arity>
+using DaryHeap = myn::priority_queue<int, myn::vector<int>, std::less<int>,
+                                     Arity>;
+}  // namespace
+
+// Push range(0) shuffled keys, then pop them all.
+template <class Heap>
+static void BM_HeapPushPop(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    Heap heap;
+    for (int key : keys) heap.push(key);
+    while (!heap.empty()) {
+      benchmark::DoNotOptimize(heap.top());
+      heap.pop();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_HeapPushPop, DaryHeap<2>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, DaryHeap<4>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, DaryHeap<8>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, std::priority_queue<int>)
+    ->Range(1 << 10, 1 << 20);
+
+// Building a heap of range(0) keys: one push_bulk (O(n) heapify) against a
+// push per key.
+template <class Heap>
+static void BM_HeapPushBulk(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    Heap heap;
+    heap.push_bulk(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(heap.top());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_HeapPushBulk, DaryHeap<2>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushBulk, DaryHeap<4>)->Range(1 << 10, 1 << 20);
+
+template <class Heap>
+static void BM_HeapPushEach(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    Heap heap;
+    for (int key : keys) heap.push(key);
+    benchmark::DoNotOptimize(heap.top());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_HeapPushEach, DaryHeap<2>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushEach, DaryHeap<4>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushEach, std::priority_queue<int>)
+    ->Range(1 << 10, 1 << 20);
@@ -0,0 +1,71 @@
+#include <queue>
+
+#include "main.h"
+
+namespace {
+// The node-per-element queue myn::queue used to be.
+template <typename T>
+class NodeQueue {
+ public:
+  ~NodeQueue() {
+    while (head_ != nullptr) pop();
+  }
+  const T &front() const { return head_->value; }
+  bool empty() const { return head_ == nullptr; }
+  void push(const T &value) {
+    Node *node = new Node(value);
+    (tail_ ? tail_->next : head_) = node;
+    tail_ = node;
+  }
+  void pop() {
+    Node *old = head_;
+    head_ = head_->next;
+    if (head_ == nullptr) tail_ = nullptr;
+    delete old;
+  }
+
+ private:
+  struct Node {
+    explicit Node(T val) : value(val) {}
+    T value;
+    Node *next = nullptr;
+  };
+  Node *head_ = nullptr;
+  Node *tail_ = nullptr;
+};
+}  // namespace
+
+// Steady state of a message queue holding n messages: every push is
+// matched by a pop.
+template <class Queue>
+static void BM_QueueSteadyState(benchmark::State &state) {
+  Queue q;
+  for (long i = 0; i < state.range(0); ++i) q.push(static_cast<int>(i));
+  for (auto _ : state) {
+    q.push(q.front());
+    q.pop();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_QueueSteadyState, myn::queue<int>)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_QueueSteadyState, NodeQueue<int>)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_QueueSteadyState, std::queue<int>)->Arg(1024);
+
+// Fill to n, then drain.
+template <class Queue>
+static void BM_QueueFillDrain(benchmark::State &state) {
+  for (auto _ : state) {
+    Queue q;
+    for (long i = 0; i < state.range(0); ++i) q.push(static_cast<int>(i));
+    long sum = 0;
+    while (!q.empty()) {
+      sum += q.front();
+      q.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_QueueFillDrain, myn::queue<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_QueueFillDrain, NodeQueue<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_QueueFillDrain, std::queue<int>)->Arg(1 << 16);
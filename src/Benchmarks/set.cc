@@ -0,0 +1,272 @@
+#include <set>
+
+#include "main.h"
+
+// Position of a key: rank() on a ranked set against counting steps from
+// begin(), which is what an unranked set offers.
+static void BM_SetRank(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::set<int, true> st;
+  for (int key : keys) st.insert(key);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(st.rank(keys[i++ % keys.size()]));
+  }
+}
+BENCHMARK(BM_SetRank)->Range(1 << 10, 1 << 16);
+
+static void BM_SetRankByWalk(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::set<int> st;
+  for (int key : keys) st.insert(key);
+  size_t i = 0;
+  for (auto _ : state) {
+    int key = keys[i++ % keys.size()];
+    size_t rank = 0;
+    for (auto it = st.begin(); *it < key; ++it) ++rank;
+    benchmark::DoNotOptimize(rank);
+  }
+}
+BENCHMARK(BM_SetRankByWalk)->Range(1 << 10, 1 << 16);
+
+// What keeping the counts costs on insert.
+template <class Set>
+static void BM_SetInsert(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    Set st;
+    for (int key : keys) st.insert(key);
+    benchmark::DoNotOptimize(st.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_SetInsert, myn::set<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SetInsert, myn::set<int, true>)->Arg(1 << 16);
+
+// Sum of the keys in a window of range(1) keys at a random position, out of
+// range(0): a bounded scan against the scan from begin() it replaces.
+static void BM_SetRangeScan(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::set<int> st;
+  for (int key : keys) st.insert(key);
+  const int width = static_cast<int>(state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    int lo = keys[i++ % keys.size()];
+    long sum = 0;
+    st.for_each_in_range(lo, lo + width, [&sum](int key) { sum += key; });
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_SetRangeScan)->ArgsProduct({{1 << 16}, {10, 1 << 12}});
+
+static void BM_SetRangeScanFromBegin(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::set<int> st;
+  for (int key : keys) st.insert(key);
+  const int width = static_cast<int>(state.range(1));
+  size_t i = 0;
+  for (auto _ : state) {
+    int lo = keys[i++ % keys.size()];
+    long sum = 0;
+    for (auto it = st.begin(), end = st.end(); it != end && *it < lo + width;
+         ++it) {
+      if (*it >= lo) sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_SetRangeScanFromBegin)->ArgsProduct({{1 << 16}, {10, 1 << 12}});
+
+// Building from a million keys: the bulk build from sorted keys, from
+// shuffled keys (sorting a copy first, serially or on a pool), and insert
+// one by one from shuffled keys. Inserting sorted keys one by one would
+// degenerate the tree into a list.
+static void BM_SetAssignSorted(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  std::sort(keys.begin(), keys.end());
+  for (auto _ : state) {
+    myn::set<int> st;
+    st.assign_sorted(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(st.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetAssignSorted)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_SetAssignShuffled(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    myn::set<int> st(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(st.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetAssignShuffled)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_SetAssignShuffledParallel(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::thread_pool pool;
+  for (auto _ : state) {
+    myn::set<int> st;
+    st.assign(keys.begin(), keys.end(), pool);
+    benchmark::DoNotOptimize(st.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetAssignShuffledParallel)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_SetInsertShuffled(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    myn::set<int> st;
+    for (int key : keys) st.insert(key);
+    benchmark::DoNotOptimize(st.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetInsertShuffled)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Snapshot of a map: the copy constructor against inserting every entry
+// into a fresh map in the order that built the original, which gives the
+// same shape (inserting in sorted order would build a chain).
+static void BM_MapCopy(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::map<int, int> m;
+  for (int key : keys) m.insert(key, key);
+  for (auto _ : state) {
+    myn::map<int, int> copy(m);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MapCopy)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_MapCopyByInsert(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::map<int, int> m;
+  for (int key : keys) m.insert(key, key);
+  for (auto _ : state) {
+    myn::map<int, int> copy;
+    for (int key : keys) copy.insert(key, key);
+    benchmark::DoNotOptimize(copy.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MapCopyByInsert)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Moving the odd keys of one shard into the shard of the even keys: merge
+// relinks the nodes, against inserting copies and clearing the source.
+static void BM_SetMerge(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    myn::set<int> evens, odds;
+    for (int key : keys) (key % 2 == 0 ? evens : odds).insert(key);
+    state.ResumeTiming();
+    evens.merge(odds);
+    benchmark::DoNotOptimize(evens.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_SetMerge)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_SetMergeByInsert(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    myn::set<int> evens, odds;
+    for (int key : keys) (key % 2 == 0 ? evens : odds).insert(key);
+    state.ResumeTiming();
+    for (int key : odds) evens.insert(key);
+    odds.clear();
+    benchmark::DoNotOptimize(evens.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+}
+BENCHMARK(BM_SetMergeByInsert)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+// Intersection of posting lists of range(0) and range(1) ids: the merge of
+// both traversals (a finger search through the larger one when the sizes
+// are far apart) against probing the larger set for every id of the
+// smaller one.
+static void PostingLists(long n, long m, myn::set<int> &large,
+                         myn::set<int> &small) {
+  std::vector<int> ids;
+  for (long i = 0; i < n; ++i) ids.push_back(static_cast<int>(i * 2));
+  large.assign_sorted(ids.begin(), ids.end());
+  ids = ShuffledKeys(2 * n);
+  ids.resize(m);
+  small.assign(ids.begin(), ids.end());
+}
+
+static void BM_SetIntersection(benchmark::State &state) {
+  myn::set<int> large, small;
+  PostingLists(state.range(0), state.range(1), large, small);
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    myn::set_intersection(small, large, std::back_inserter(out));
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_SetIntersection)
+    ->Args({1 << 20, 1 << 20})
+    ->Args({1 << 20, 1 << 15})
+    ->Args({1 << 20, 1 << 10})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_SetIntersectionByContains(benchmark::State &state) {
+  myn::set<int> large, small;
+  PostingLists(state.range(0), state.range(1), large, small);
+  std::vector<int> out;
+  for (auto _ : state) {
+    out.clear();
+    for (int id : small) {
+      if (large.contains(id)) out.push_back(id);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+}
+BENCHMARK(BM_SetIntersectionByContains)
+    ->Args({1 << 20, 1 << 20})
+    ->Args({1 << 20, 1 << 15})
+    ->Args({1 << 20, 1 << 10})
+    ->Unit(benchmark::kMicrosecond);
+
+// Full scan of range(0) keys along the in-order chain, in a set built by
+// inserts (nodes scattered over the heap) and in a bulk-built one (nodes in
+// key order in one block), with std::set for reference.
+static void BM_SetScan(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  myn::set<int> st;
+  if (state.range(1) != 0) {
+    st.assign(keys.begin(), keys.end());
+  } else {
+    for (int key : keys) st.insert(key);
+  }
+  for (auto _ : state) {
+    long sum = 0;
+    for (int key : st) sum += key;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SetScan)
+    ->ArgsProduct({{10000000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_StdSetScan(benchmark::State &state) {
+  std::vector<int> keys = ShuffledKeys(state.range(0));
+  std::set<int> st(keys.begin(), keys.end());
+  for (auto _ : state) {
+    long sum = 0;
+    for (int key : st) sum += key;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSetScan)->Arg(10000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,146 @@
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "main.h"
+
+namespace {
+// Pins the calling thread to one CPU, so producer and consumer stay on
+// their own cores for the whole run. A no-op where unsupported.
+void PinToCpu(unsigned cpu) {
+#ifdef __linux__
+  unsigned cpus = std::thread::hardware_concurrency();
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpus ? cpu % cpus : 0, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+// The pipeline's previous hand-off: myn::queue behind a mutex, with the
+// same try_push/try_pop/push_n/pop_n surface so one driver runs both.
+class LockedQueue {
+ public:
+  explicit LockedQueue(size_t capacity) : capacity_(capacity) {}
+  bool try_push(long value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() == capacity_) return false;
+    queue_.push(value);
+    return true;
+  }
+  bool try_pop(long &value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+    value = queue_.front();
+    queue_.pop();
+    return true;
+  }
+  size_t push_n(const long *first, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t i = 0;
+    for (; i < n && queue_.size() < capacity_; ++i) queue_.push(first[i]);
+    return i;
+  }
+  size_t pop_n(long *out, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t i = 0;
+    for (; i < n && !queue_.empty(); ++i) {
+      out[i] = queue_.front();
+      queue_.pop();
+    }
+    return i;
+  }
+
+ private:
+  std::mutex mutex_;
+  myn::queue<long> queue_;
+  size_t capacity_;
+};
+
+constexpr long kMessages = 1 << 20;
+}  // namespace
+
+// Throughput: the producer streams kMessages through a 1024-slot ring to a
+// consumer on another core, in batches of state.range(0).
+template <class Queue>
+static void BM_SpscThroughput(benchmark::State &state) {
+  const size_t batch = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    Queue q(1024);
+    std::thread producer([&q, batch] {
+      PinToCpu(1);
+      long buffer[64];
+      for (long next = 0; next < kMessages;) {
+        if (batch == 1) {
+          if (q.try_push(next)) ++next;
+        } else {
+          size_t n = 0;
+          for (; n < batch && next + static_cast<long>(n) < kMessages; ++n) {
+            buffer[n] = next + static_cast<long>(n);
+          }
+          next += static_cast<long>(q.push_n(buffer, n));
+        }
+      }
+    });
+    PinToCpu(0);
+    long sum = 0;
+    long buffer[64];
+    for (long received = 0; received < kMessages;) {
+      size_t n = q.pop_n(buffer, batch);
+      for (size_t i = 0; i < n; ++i) sum += buffer[i];
+      received += static_cast<long>(n);
+    }
+    producer.join();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kMessages);
+}
+BENCHMARK_TEMPLATE(BM_SpscThroughput, myn::spsc_queue<long>)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SpscThroughput, LockedQueue)
+    ->Arg(1)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Latency: one message bounces between the two threads through a pair of
+// queues; the time per iteration is one round trip.
+template <class Queue>
+static void BM_SpscRoundTrip(benchmark::State &state) {
+  Queue ping(64);
+  Queue pong(64);
+  std::atomic<bool> done{false};
+  std::thread echo([&] {
+    PinToCpu(1);
+    long value;
+    while (!done.load(std::memory_order_relaxed)) {
+      if (ping.try_pop(value)) {
+        while (!pong.try_push(value)) {
+        }
+      }
+    }
+  });
+  PinToCpu(0);
+  long value = 0;
+  for (auto _ : state) {
+    while (!ping.try_push(value)) {
+    }
+    while (!pong.try_pop(value)) {
+    }
+  }
+  done.store(true);
+  echo.join();
+}
+BENCHMARK_TEMPLATE(BM_SpscRoundTrip, myn::spsc_queue<long>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SpscRoundTrip, LockedQueue)->UseRealTime();
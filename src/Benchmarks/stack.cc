@@ -0,0 +1,77 @@
+#include <stack>
+
+#include "main.h"
+
+namespace {
+// The node-per-element stack myn::stack used to be: one new on every push,
+// one delete on every pop.
+template <typename T>
+class NodeStack {
+ public:
+  NodeStack() = default;
+  NodeStack(const NodeStack &other) {
+    NodeStack temp;
+    for (Node *node = other.top_; node != nullptr; node = node->next) {
+      temp.push(node->value);
+    }
+    while (!temp.empty()) {
+      push(temp.top());
+      temp.pop();
+    }
+  }
+  ~NodeStack() {
+    while (!empty()) pop();
+  }
+  const T &top() const { return top_->value; }
+  bool empty() const { return top_ == nullptr; }
+  void push(const T &value) { top_ = new Node{value, top_}; }
+  void pop() {
+    Node *old = top_;
+    top_ = top_->next;
+    delete old;
+  }
+
+ private:
+  struct Node {
+    T value;
+    Node *next;
+  };
+  Node *top_ = nullptr;
+};
+}  // namespace
+
+// Grows to n elements and drains again, so a warm contiguous stack runs
+// without touching the allocator.
+template <class Stack>
+static void BM_StackPushPop(benchmark::State &state) {
+  Stack s;
+  for (auto _ : state) {
+    for (long i = 0; i < state.range(0); ++i) s.push(static_cast<int>(i));
+    long sum = 0;
+    while (!s.empty()) {
+      sum += s.top();
+      s.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_StackPushPop, myn::stack<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StackPushPop, myn::stack<int, myn::list<int>>)
+    ->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StackPushPop, NodeStack<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StackPushPop, std::stack<int>)->Arg(1 << 16);
+
+template <class Stack>
+static void BM_StackCopy(benchmark::State &state) {
+  Stack s;
+  for (long i = 0; i < state.range(0); ++i) s.push(static_cast<int>(i));
+  for (auto _ : state) {
+    Stack copy(s);
+    benchmark::DoNotOptimize(copy.top());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_StackCopy, myn::stack<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StackCopy, NodeStack<int>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StackCopy, std::stack<int>)->Arg(1 << 16);
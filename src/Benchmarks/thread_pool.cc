@@ -0,0 +1,72 @@
+#include <atomic>
+#include <thread>
+
+#include "main.h"
+
+namespace {
+constexpr int kSetKeys = 1 << 20;
+
+const myn::set<int> &SharedSet() {
+  static const myn::set<int> *set = [] {
+    auto *s = new myn::set<int>;
+    for (int key : ShuffledKeys(kSetKeys)) s->insert(key);
+    return s;
+  }();
+  return *set;
+}
+
+const int kMaxThreads = static_cast<int>(std::thread::hardware_concurrency());
+}  // namespace
+
+static void BM_SetSumSequential(benchmark::State &state) {
+  const myn::set<int> &set = SharedSet();
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = set.begin(); it != set.end(); ++it) sum += *it;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kSetKeys);
+}
+BENCHMARK(BM_SetSumSequential)->Unit(benchmark::kMillisecond);
+
+// Fork-join sum over the same set: parallel_for halves the key range down
+// to 4K-key leaves, and each leaf walks its keys from find(lo).
+static void BM_SetSumParallel(benchmark::State &state) {
+  const myn::set<int> &set = SharedSet();
+  myn::thread_pool pool(state.range(0));
+  for (auto _ : state) {
+    std::atomic<long> sum{0};
+    pool.parallel_for(0, kSetKeys, 4096, [&set, &sum](int lo, int hi) {
+      long local = 0;
+      auto it = set.find(lo);
+      for (int key = lo; key < hi; ++key, ++it) local += *it;
+      sum.fetch_add(local, std::memory_order_relaxed);
+    });
+    benchmark::DoNotOptimize(sum.load());
+  }
+  state.SetItemsProcessed(state.iterations() * kSetKeys);
+}
+BENCHMARK(BM_SetSumParallel)
+    ->DenseRange(1, kMaxThreads)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Recursive fork-join with tiny tasks: measures scheduling overhead.
+static long ParallelFib(myn::thread_pool &pool, int n) {
+  if (n < 2) return n;
+  if (n < 16) return ParallelFib(pool, n - 1) + ParallelFib(pool, n - 2);
+  long results[2];
+  pool.parallel_for(0, 2, 1, [&pool, &results, n](int lo, int) {
+    results[lo] = ParallelFib(pool, n - 1 - lo);
+  });
+  return results[0] + results[1];
+}
+
+static void BM_ForkJoinFib(benchmark::State &state) {
+  myn::thread_pool pool(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(ParallelFib(pool, 30));
+}
+BENCHMARK(BM_ForkJoinFib)
+    ->DenseRange(1, kMaxThreads)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
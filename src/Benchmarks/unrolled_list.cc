@@ -0,0 +1,35 @@
+#include "main.h"
+
+template <class Container>
+static void BM_Traversal(benchmark::State &state) {
+  Container c;
+  for (long i = 0; i < state.range(0); ++i) c.push_back(static_cast<int>(i));
+  for (auto _ : state) {
+    long sum = 0;
+    for (auto it = c.begin(), end = c.end(); it != end; ++it) sum += *it;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Traversal, myn::unrolled_list<int>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Traversal, myn::list<int>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Traversal, myn::vector<int>)->Arg(1 << 20);
+
+// Repeated insertion at an iterator held in the middle of the container.
+template <class Container>
+static void BM_MiddleInsert(benchmark::State &state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    Container c;
+    for (long i = 0; i < state.range(0); ++i) c.push_back(static_cast<int>(i));
+    auto it = c.begin();
+    for (long i = 0; i < state.range(0) / 2; ++i) ++it;
+    state.ResumeTiming();
+    for (int i = 0; i < 10000; ++i) it = c.insert(it, i);
+    benchmark::DoNotOptimize(*it);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK_TEMPLATE(BM_MiddleInsert, myn::unrolled_list<int>)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(BM_MiddleInsert, myn::list<int>)->Arg(1 << 18);
+BENCHMARK_TEMPLATE(BM_MiddleInsert, myn::vector<int>)->Arg(1 << 18);
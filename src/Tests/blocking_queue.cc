@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(BlockingQueue, TryOperations) {
+  myn::blocking_queue<std::string> q(2);
+  EXPECT_EQ(q.capacity(), 2U);
+  std::string value;
+  EXPECT_FALSE(q.try_pop(value));
+  EXPECT_TRUE(q.try_push("a"));
+  EXPECT_TRUE(q.try_emplace(2, 'b'));
+  EXPECT_FALSE(q.try_push("c"));
+  EXPECT_EQ(q.size(), 2U);
+  ASSERT_TRUE(q.try_pop(value));
+  EXPECT_EQ(value, "a");
+  ASSERT_TRUE(q.pop(value));
+  EXPECT_EQ(value, "bb");
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(BlockingQueue, TimedPop) {
+  myn::blocking_queue<int> q;
+  int value = 0;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(q.try_pop_for(value, std::chrono::milliseconds(20)));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(20));
+  std::thread producer([&q] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    q.push(7);
+  });
+  EXPECT_TRUE(q.try_pop_for(value, std::chrono::seconds(10)));
+  EXPECT_EQ(value, 7);
+  producer.join();
+}
+
+TEST(BlockingQueue, CloseDrainsThenFails) {
+  myn::blocking_queue<int> q;
+  q.push(1);
+  q.push(2);
+  q.push(3);
+  q.close();
+  EXPECT_TRUE(q.closed());
+  EXPECT_FALSE(q.push(4));
+  EXPECT_FALSE(q.try_push(4));
+  std::vector<int> out;
+  EXPECT_EQ(q.pop_bulk(std::back_inserter(out), 2), 2U);
+  int value;
+  EXPECT_TRUE(q.pop(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_FALSE(q.pop(value));
+  EXPECT_EQ(q.pop_bulk(std::back_inserter(out), 2), 0U);
+  EXPECT_EQ(out, (std::vector<int>{1, 2}));
+}
+
+TEST(BlockingQueue, CloseWakesSleepers) {
+  myn::blocking_queue<int> q(1);
+  q.push(0);
+  std::thread producer([&q] { EXPECT_FALSE(q.push(1)); });
+  myn::blocking_queue<int> empty;
+  std::thread consumer([&empty] {
+    int value;
+    EXPECT_FALSE(empty.pop(value));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  q.close();
+  empty.close();
+  producer.join();
+  consumer.join();
+}
+
+// A bounded queue never holds more than its capacity, and every value gets
+// through exactly once, in each producer's order.
+TEST(BlockingQueue, BackpressureAndBulkDrain) {
+  const int kProducers = 3;
+  const int kPerProducer = 20000;
+  const size_t kCapacity = 16;
+  myn::blocking_queue<int> q(kCapacity);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&q, p] {
+      for (int i = 0; i < kPerProducer; ++i) q.push(p * kPerProducer + i);
+    });
+  }
+  std::vector<int> seen(kProducers * kPerProducer);
+  std::vector<int> last(kProducers, -1);
+  bool ordered = true;
+  std::thread consumer([&] {
+    int batch[64];
+    size_t n;
+    while ((n = q.pop_bulk(batch, 64)) != 0) {
+      EXPECT_LE(n, kCapacity);
+      for (size_t i = 0; i < n; ++i) {
+        int producer = batch[i] / kPerProducer;
+        if (batch[i] <= last[producer]) ordered = false;
+        last[producer] = batch[i];
+        ++seen[batch[i]];
+      }
+    }
+  });
+  for (auto &producer : producers) producer.join();
+  q.close();
+  consumer.join();
+  EXPECT_TRUE(ordered);
+  for (int count : seen) ASSERT_EQ(count, 1);
+}
@@ -0,0 +1,114 @@
+#include "main.h"
+
+#ifdef __cpp_impl_coroutine
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+myn::task Produce(myn::channel<int> &ch, int first, int count,
+                  std::vector<std::string> &log) {
+  for (int i = first; i < first + count; ++i) {
+    bool sent = co_await ch.send(i);
+    log.push_back((sent ? "sent " : "dropped ") + std::to_string(i));
+  }
+}
+
+myn::task Consume(myn::channel<int> &ch, std::vector<int> &out) {
+  while (std::optional<int> value = co_await ch.receive()) {
+    out.push_back(*value);
+  }
+  out.push_back(-1);
+}
+}  // namespace
+
+TEST(Channel, BufferedProducerConsumer) {
+  myn::executor ex;
+  myn::channel<int> ch(ex, 2);
+  std::vector<std::string> log;
+  std::vector<int> out;
+  ex.spawn(Produce(ch, 0, 5, log));
+  ex.spawn(Consume(ch, out));
+  ex.run();
+  // The producer filled the buffer and waited for room.
+  EXPECT_EQ(log.size(), 5U);
+  EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4}));
+  ch.close();
+  ex.run();
+  EXPECT_EQ(out.back(), -1);
+}
+
+TEST(Channel, UnbufferedHandsOverDirectly) {
+  myn::executor ex;
+  myn::channel<int> ch(ex);
+  std::vector<std::string> log;
+  ex.spawn(Produce(ch, 0, 1, log));
+  ex.run();
+  EXPECT_TRUE(log.empty());
+  EXPECT_EQ(ch.size(), 0U);
+  EXPECT_EQ(ch.try_receive(), 0);
+  EXPECT_FALSE(ch.try_receive().has_value());
+  ex.run();
+  EXPECT_EQ(log, (std::vector<std::string>{"sent 0"}));
+}
+
+// Waiters are served in the order they started waiting, on both sides.
+TEST(Channel, FifoWakeups) {
+  myn::executor ex;
+  myn::channel<int> ch(ex);
+  std::vector<int> first;
+  std::vector<int> second;
+  ex.spawn(Consume(ch, first));
+  ex.spawn(Consume(ch, second));
+  ex.run();
+  EXPECT_TRUE(ch.try_send(1));
+  EXPECT_TRUE(ch.try_send(2));
+  EXPECT_FALSE(ch.try_send(3));
+  ex.run();
+  EXPECT_EQ(first, (std::vector<int>{1}));
+  EXPECT_EQ(second, (std::vector<int>{2}));
+
+  std::vector<std::string> log;
+  ex.spawn(Produce(ch, 10, 1, log));
+  ex.spawn(Produce(ch, 20, 1, log));
+  ex.spawn(Produce(ch, 30, 1, log));
+  ex.run();
+  ch.close();
+  ex.run();
+  // 30 waited for a receiver, and first was back before second.
+  EXPECT_EQ(first, (std::vector<int>{1, 10, 30, -1}));
+  EXPECT_EQ(second, (std::vector<int>{2, 20, -1}));
+  EXPECT_EQ(log, (std::vector<std::string>{"sent 10", "sent 20", "sent 30"}));
+}
+
+TEST(Channel, CloseDrainsBuffer) {
+  myn::executor ex;
+  myn::channel<std::unique_ptr<int>> ch(ex, 4);
+  EXPECT_TRUE(ch.try_send(std::make_unique<int>(1)));
+  EXPECT_TRUE(ch.try_send(std::make_unique<int>(2)));
+  ch.close();
+  EXPECT_TRUE(ch.closed());
+  EXPECT_FALSE(ch.try_send(std::make_unique<int>(3)));
+  EXPECT_EQ(*ch.try_receive().value(), 1);
+  EXPECT_EQ(*ch.try_receive().value(), 2);
+  EXPECT_FALSE(ch.try_receive().has_value());
+}
+
+// Destroying the executor destroys coroutines that never got to run.
+TEST(Channel, UnrunTasksAreDestroyed) {
+  auto counter = std::make_shared<int>(0);
+  {
+    myn::executor ex;
+    myn::channel<int> ch(ex, 1);
+    ex.spawn([](std::shared_ptr<int> held) -> myn::task {
+      ++*held;
+      co_return;
+    }(counter));
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+  EXPECT_EQ(*counter, 0);
+}
+
+#endif  // __cpp_impl_coroutine
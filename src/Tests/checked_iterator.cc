@@ -0,0 +1,94 @@
+#include "main.h"
+
+#ifdef MYN_CHECKED_ITERATORS
+
+TEST(CheckedIterator, vector_stale_after_reserve) {
+  myn::vector<int> vec{1, 2, 3};
+  auto it = vec.begin();
+  ASSERT_EQ(*it, 1);
+  vec.reserve(100);
+  EXPECT_THROW(*it, std::logic_error);
+  EXPECT_EQ(*vec.begin(), 1);
+}
+
+TEST(CheckedIterator, vector_survives_push_back_without_realloc) {
+  myn::vector<int> vec;
+  vec.reserve(8);
+  vec.push_back(1);
+  auto it = vec.begin();
+  vec.push_back(2);
+  EXPECT_EQ(*it, 1);
+  EXPECT_EQ(*(++it), 2);
+}
+
+TEST(CheckedIterator, vector_out_of_range) {
+  myn::vector<int> vec{1, 2, 3};
+  auto it = vec.end();
+  EXPECT_THROW(*it, std::out_of_range);
+  EXPECT_THROW(++it, std::out_of_range);
+  it = vec.begin();
+  EXPECT_THROW(--it, std::out_of_range);
+  EXPECT_THROW(vec.begin()[3], std::out_of_range);
+}
+
+TEST(CheckedIterator, set_stale_after_erase) {
+  myn::set<int> st{4, 6, 7, 3, 1};
+  auto it = st.find(6);
+  st.erase(st.find(3));
+  EXPECT_THROW(*it, std::logic_error);
+  EXPECT_THROW(++it, std::logic_error);
+  EXPECT_THROW(st.erase(it), std::logic_error);
+  EXPECT_EQ(*st.find(6), 6);
+}
+
+TEST(CheckedIterator, set_out_of_range) {
+  myn::set<int> st{4, 6, 7};
+  auto it = st.end();
+  EXPECT_THROW(*it, std::out_of_range);
+  EXPECT_THROW(++it, std::out_of_range);
+  it = st.begin();
+  EXPECT_THROW(--it, std::out_of_range);
+}
+
+TEST(CheckedIterator, set_survives_insert) {
+  myn::set<int> st{4, 6, 7};
+  auto it = st.find(6);
+  st.insert(5);
+  EXPECT_EQ(*it, 6);
+}
+
+TEST(CheckedIterator, list_stale_after_erase) {
+  myn::list<int> l{1, 2, 3};
+  auto it = l.begin();
+  ++it;
+  l.pop_front();
+  EXPECT_THROW(*it, std::logic_error);
+  auto res = l.erase(l.begin());
+  EXPECT_EQ(*res, 3);
+}
+
+TEST(CheckedIterator, list_out_of_range) {
+  myn::list<int> l{1, 2, 3};
+  auto it = l.end();
+  EXPECT_THROW(*it, std::out_of_range);
+  EXPECT_THROW(++it, std::out_of_range);
+  it = l.begin();
+  EXPECT_THROW(--it, std::out_of_range);
+  EXPECT_THROW(*l.cend(), std::out_of_range);
+}
+
+#else
+
+// Without MYN_CHECKED_ITERATORS the iterators must stay a bare pointer.
+static_assert(sizeof(myn::vector<int>::iterator) == sizeof(int *),
+              "vector iterator must be pointer-sized");
+static_assert(sizeof(myn::vector<int>::const_iterator) == sizeof(int *),
+              "vector const_iterator must be pointer-sized");
+static_assert(sizeof(myn::set<int>::iterator) == sizeof(void *),
+              "set iterator must be pointer-sized");
+static_assert(sizeof(myn::list<int>::iterator) == sizeof(void *),
+              "list iterator must be pointer-sized");
+static_assert(sizeof(myn::list<int>::const_iterator) == sizeof(void *),
+              "list const_iterator must be pointer-sized");
+
+#endif
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(ConcurrentMap, InsertFindErase) {
+  myn::concurrent_map<int, std::string> m{{3, "c"}, {1, "a"}, {2, "b"}};
+  EXPECT_EQ(m.size(), 3U);
+  EXPECT_FALSE(m.insert(2, "x"));
+  EXPECT_EQ(m.find(2)->second, "b");
+  EXPECT_TRUE(m.contains(3));
+  EXPECT_FALSE(m.contains(4));
+  EXPECT_EQ(m.find(4), m.end());
+  EXPECT_EQ(m.erase(2), 1U);
+  EXPECT_EQ(m.erase(2), 0U);
+  EXPECT_FALSE(m.contains(2));
+  EXPECT_TRUE(m.insert(2, "y"));
+  EXPECT_EQ(m.find(2)->second, "y");
+  EXPECT_EQ(m.size(), 3U);
+}
+
+TEST(ConcurrentMap, OrderedIteration) {
+  myn::concurrent_map<int, int> m;
+  std::map<int, int> fact;
+  for (int i = 0; i < 1000; ++i) {
+    int key = (i * 7919) % 1000;
+    m.insert(key, i);
+    fact.insert({key, i});
+  }
+  for (int key = 0; key < 1000; key += 3) {
+    m.erase(key);
+    fact.erase(key);
+  }
+  auto it = m.begin();
+  for (const auto &item : fact) {
+    ASSERT_NE(it, m.end());
+    EXPECT_EQ(it->first, item.first);
+    EXPECT_EQ(it->second, item.second);
+    ++it;
+  }
+  EXPECT_EQ(it, m.end());
+  EXPECT_EQ(m.size(), fact.size());
+}
+
+TEST(ConcurrentMap, LowerBoundRange) {
+  myn::concurrent_map<int, int> m;
+  for (int i = 0; i < 100; i += 10) m.insert(i, i);
+  std::vector<int> keys;
+  for (auto it = m.lower_bound(25); it != m.end() && it->first < 60; ++it) {
+    keys.push_back(it->first);
+  }
+  EXPECT_EQ(keys, (std::vector<int>{30, 40, 50}));
+  EXPECT_EQ(m.lower_bound(100), m.end());
+}
+
+TEST(ConcurrentMap, Clear) {
+  myn::concurrent_map<int, int> m;
+  for (int i = 0; i < 100; ++i) m.insert(i, i);
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.size(), 0U);
+  EXPECT_TRUE(m.insert(5, 5));
+}
+
+// Every thread inserts its own keys, erases half of them again and reads
+// everyone else's; whatever the interleaving, the survivors are the odd
+// keys, in order.
+TEST(ConcurrentMap, ConcurrentInsertErase) {
+  const int kThreads = 4;
+  const int kPerThread = 5000;
+  myn::concurrent_map<int, int> m;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&m, t] {
+      for (int i = t; i < kThreads * kPerThread; i += kThreads) {
+        EXPECT_TRUE(m.insert(i, -i));
+      }
+      for (int i = t; i < kThreads * kPerThread; i += kThreads) {
+        m.contains(i ^ 1);
+        if (i % 2 == 0) {
+          EXPECT_EQ(m.erase(i), 1U);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_EQ(m.size(), static_cast<size_t>(kThreads * kPerThread / 2));
+  int expected = 1;
+  for (const auto &item : m) {
+    EXPECT_EQ(item.first, expected);
+    EXPECT_EQ(item.second, -expected);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, kThreads * kPerThread + 1);
+}
+
+// Threads fight over the same small key range.
+TEST(ConcurrentMap, ContendedKeys) {
+  const int kThreads = 4;
+  myn::concurrent_map<int, int> m;
+  std::vector<std::thread> threads;
+  std::atomic<long> balance{0};
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&m, &balance, t] {
+      for (int i = 0; i < 20000; ++i) {
+        int key = (i * 31 + t) % 64;
+        if (m.insert(key, key)) ++balance;
+        if (m.erase((key * 17) % 64)) --balance;
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  long count = 0;
+  int previous = -1;
+  for (const auto &item : m) {
+    EXPECT_LT(previous, item.first);
+    previous = item.first;
+    ++count;
+  }
+  EXPECT_EQ(count, balance.load());
+  EXPECT_EQ(static_cast<long>(m.size()), balance.load());
+}
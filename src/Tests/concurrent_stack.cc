@@ -0,0 +1,69 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(ConcurrentStack, Lifo) {
+  myn::concurrent_stack<std::string> s;
+  std::string value;
+  EXPECT_TRUE(s.empty());
+  EXPECT_FALSE(s.try_pop(value));
+  s.push("a");
+  std::string b = "b";
+  s.push(b);
+  s.emplace(3, 'c');
+  EXPECT_FALSE(s.empty());
+  ASSERT_TRUE(s.try_pop(value));
+  EXPECT_EQ(value, "ccc");
+  ASSERT_TRUE(s.try_pop(value));
+  EXPECT_EQ(value, "b");
+  ASSERT_TRUE(s.try_pop(value));
+  EXPECT_EQ(value, "a");
+  EXPECT_FALSE(s.try_pop(value));
+}
+
+TEST(ConcurrentStack, DestructorFreesElements) {
+  myn::concurrent_stack<std::string> s;
+  for (int i = 0; i < 100; ++i) s.push(std::string(64, 'x'));
+}
+
+namespace {
+// Producers push every value in [0, kThreads * kPerThread) exactly once
+// while consumers pop; each value must come out exactly once.
+template <class Stack>
+void CheckEveryValuePoppedOnce() {
+  const int kThreads = 4;
+  const int kPerThread = 20000;
+  Stack s;
+  std::vector<std::atomic<int>> seen(kThreads * kPerThread);
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&s, t] {
+      for (int i = 0; i < kPerThread; ++i) s.push(t * kPerThread + i);
+    });
+    threads.emplace_back([&s, &seen, &popped] {
+      int value;
+      while (popped.load() < kThreads * kPerThread) {
+        if (s.try_pop(value)) {
+          seen[value].fetch_add(1);
+          popped.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_TRUE(s.empty());
+  for (auto &count : seen) ASSERT_EQ(count.load(), 1);
+}
+}  // namespace
+
+TEST(ConcurrentStack, ProducersAndConsumers) {
+  CheckEveryValuePoppedOnce<myn::concurrent_stack<int>>();
+}
+
+TEST(ConcurrentStack, EliminationProducersAndConsumers) {
+  CheckEveryValuePoppedOnce<myn::concurrent_stack<int, 4>>();
+}
@@ -0,0 +1,149 @@
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "main.h"
+
+TEST(IndexedPriorityQueue, PushPopContains) {
+  myn::indexed_priority_queue<int> q;
+  q.push(3, 30);
+  q.push(10, 5);
+  q.push(0, 20);
+  EXPECT_EQ(q.size(), 3U);
+  EXPECT_TRUE(q.contains(10));
+  EXPECT_FALSE(q.contains(1));
+  EXPECT_FALSE(q.contains(1000));
+  EXPECT_EQ(q.key(3), 30);
+  EXPECT_THROW(q.push(3, 1), std::invalid_argument);
+  EXPECT_EQ(q.top_id(), 10U);
+  EXPECT_EQ(q.top_key(), 5);
+  q.pop();
+  EXPECT_FALSE(q.contains(10));
+  EXPECT_EQ(q.top_id(), 0U);
+  q.push(10, 1);
+  EXPECT_EQ(q.top_id(), 10U);
+  q.clear();
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.contains(3));
+  EXPECT_THROW(q.top_id(), std::logic_error);
+  EXPECT_THROW(q.pop(), std::logic_error);
+}
+
+TEST(IndexedPriorityQueue, ChangeKeys) {
+  myn::indexed_priority_queue<int> q(8);
+  for (size_t id = 0; id < 8; ++id) q.push(id, static_cast<int>(10 * id));
+  q.decrease_key(6, -1);
+  EXPECT_EQ(q.top_id(), 6U);
+  q.increase_key(6, 100);
+  EXPECT_EQ(q.top_id(), 0U);
+  q.update_key(0, 55);
+  EXPECT_EQ(q.top_id(), 1U);
+  q.update_key(7, 2);
+  EXPECT_EQ(q.top_id(), 7U);
+  EXPECT_THROW(q.decrease_key(1, 50), std::invalid_argument);
+  EXPECT_THROW(q.increase_key(1, 0), std::invalid_argument);
+  EXPECT_THROW(q.decrease_key(9, 0), std::out_of_range);
+  EXPECT_THROW(q.key(9), std::out_of_range);
+  EXPECT_EQ(q.erase(1), 1U);
+  EXPECT_EQ(q.erase(1), 0U);
+  std::vector<size_t> order;
+  while (!q.empty()) {
+    order.push_back(q.top_id());
+    q.pop();
+  }
+  EXPECT_EQ(order, (std::vector<size_t>{7, 2, 3, 4, 5, 0, 6}));
+}
+
+// Random pushes, key changes and erases against a brute-force model.
+TEST(IndexedPriorityQueue, MatchesModel) {
+  const size_t kIds = 300;
+  myn::indexed_priority_queue<int, std::greater<int>, 4> q;
+  std::vector<int> model(kIds);
+  std::vector<bool> present(kIds);
+  std::mt19937 rng(7);
+  for (int step = 0; step < 20000; ++step) {
+    size_t id = rng() % kIds;
+    int key = static_cast<int>(rng() % 1000);
+    switch (rng() % 4) {
+      case 0:
+        if (!present[id]) {
+          q.push(id, key);
+          present[id] = true;
+          model[id] = key;
+        }
+        break;
+      case 1:
+        if (present[id]) {
+          q.update_key(id, key);
+          model[id] = key;
+        }
+        break;
+      case 2:
+        EXPECT_EQ(q.erase(id), present[id] ? 1U : 0U);
+        present[id] = false;
+        break;
+      default:
+        if (!q.empty()) {
+          int best = std::numeric_limits<int>::min();
+          for (size_t i = 0; i < kIds; ++i) {
+            if (present[i] && model[i] > best) best = model[i];
+          }
+          ASSERT_EQ(q.top_key(), best);
+          ASSERT_EQ(model[q.top_id()], best);
+          present[q.top_id()] = false;
+          q.pop();
+        }
+    }
+    ASSERT_EQ(q.contains(id), present[id]);
+  }
+}
+
+TEST(IndexedPriorityQueue, Dijkstra) {
+  const size_t kNodes = 500;
+  std::vector<std::vector<std::pair<size_t, int>>> graph(kNodes);
+  std::mt19937 rng(3);
+  for (size_t i = 0; i < kNodes * 6; ++i) {
+    graph[rng() % kNodes].emplace_back(rng() % kNodes, rng() % 100);
+  }
+  const int kInf = std::numeric_limits<int>::max();
+
+  std::vector<int> dist(kNodes, kInf);
+  myn::indexed_priority_queue<int> q(kNodes);
+  dist[0] = 0;
+  q.push(0, 0);
+  while (!q.empty()) {
+    size_t u = q.top_id();
+    q.pop();
+    for (auto [v, w] : graph[u]) {
+      if (dist[u] + w >= dist[v]) continue;
+      dist[v] = dist[u] + w;
+      if (q.contains(v)) {
+        q.decrease_key(v, dist[v]);
+      } else {
+        q.push(v, dist[v]);
+      }
+    }
+  }
+
+  // Lazy-deletion reference.
+  std::vector<int> expected(kNodes, kInf);
+  using Item = std::pair<int, size_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> heap;
+  expected[0] = 0;
+  heap.push({0, 0});
+  while (!heap.empty()) {
+    auto [d, u] = heap.top();
+    heap.pop();
+    if (d > expected[u]) continue;
+    for (auto [v, w] : graph[u]) {
+      if (d + w < expected[v]) {
+        expected[v] = d + w;
+        heap.push({expected[v], v});
+      }
+    }
+  }
+  EXPECT_EQ(dist, expected);
+}
@@ -0,0 +1,142 @@
+#include <vector>
+
+#include "main.h"
+
+namespace {
+struct Connection {
+  explicit Connection(int id) : id(id) {}
+  int id;
+  myn::intrusive_list_hook active;
+  myn::intrusive_list_hook idle;
+};
+
+using ActiveList = myn::intrusive_list<Connection, &Connection::active>;
+using IdleList = myn::intrusive_list<Connection, &Connection::idle>;
+
+std::vector<int> Ids(ActiveList &list) {
+  std::vector<int> ids;
+  for (auto &connection : list) ids.push_back(connection.id);
+  return ids;
+}
+}  // namespace
+
+TEST(IntrusiveList, PushAndPop) {
+  Connection a(1), b(2), c(3);
+  ActiveList list;
+  EXPECT_TRUE(list.empty());
+  list.push_back(b);
+  list.push_back(c);
+  list.push_front(a);
+  EXPECT_EQ(list.size(), 3U);
+  EXPECT_EQ(Ids(list), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(&list.front(), &a);
+  EXPECT_EQ(&list.back(), &c);
+  list.pop_front();
+  list.pop_back();
+  EXPECT_EQ(Ids(list), (std::vector<int>{2}));
+  EXPECT_FALSE(a.active.is_linked());
+  EXPECT_TRUE(b.active.is_linked());
+  list.clear();
+  EXPECT_FALSE(b.active.is_linked());
+  EXPECT_THROW(list.front(), std::logic_error);
+  EXPECT_THROW(list.pop_back(), std::logic_error);
+}
+
+TEST(IntrusiveList, EraseByReference) {
+  Connection a(1), b(2), c(3);
+  ActiveList list;
+  list.push_back(a);
+  list.push_back(b);
+  list.push_back(c);
+  list.erase(b);
+  EXPECT_EQ(Ids(list), (std::vector<int>{1, 3}));
+  auto it = list.erase(list.iterator_to(a));
+  EXPECT_EQ(it->id, 3);
+  EXPECT_EQ(list.size(), 1U);
+  list.clear();
+}
+
+TEST(IntrusiveList, Insert) {
+  Connection a(1), b(2), c(3);
+  ActiveList list;
+  list.push_back(a);
+  list.push_back(c);
+  auto it = list.insert(list.iterator_to(c), b);
+  EXPECT_EQ(it->id, 2);
+  EXPECT_EQ(Ids(list), (std::vector<int>{1, 2, 3}));
+  auto back = list.end();
+  --back;
+  EXPECT_EQ((*back).id, 3);
+  list.clear();
+}
+
+TEST(IntrusiveList, TwoHooks) {
+  Connection a(1), b(2);
+  ActiveList active;
+  IdleList idle;
+  active.push_back(a);
+  active.push_back(b);
+  idle.push_back(b);
+  active.erase(b);
+  EXPECT_EQ(active.size(), 1U);
+  EXPECT_EQ(&idle.front(), &b);
+  active.clear();
+  idle.clear();
+}
+
+TEST(IntrusiveList, Splice) {
+  Connection a(1), b(2), c(3), d(4);
+  ActiveList first;
+  ActiveList second;
+  first.push_back(a);
+  first.push_back(d);
+  second.push_back(b);
+  second.push_back(c);
+  first.splice(first.iterator_to(d), second);
+  EXPECT_EQ(Ids(first), (std::vector<int>{1, 2, 3, 4}));
+  EXPECT_TRUE(second.empty());
+  second.splice(second.end(), first, a);
+  EXPECT_EQ(Ids(first), (std::vector<int>{2, 3, 4}));
+  EXPECT_EQ(&second.front(), &a);
+  first.clear();
+  second.clear();
+}
+
+TEST(IntrusiveList, SwapAndMove) {
+  Connection a(1), b(2), c(3);
+  ActiveList first;
+  ActiveList second;
+  first.push_back(a);
+  second.push_back(b);
+  second.push_back(c);
+  first.swap(second);
+  EXPECT_EQ(Ids(first), (std::vector<int>{2, 3}));
+  EXPECT_EQ(Ids(second), (std::vector<int>{1}));
+  ActiveList third(std::move(first));
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(Ids(third), (std::vector<int>{2, 3}));
+  third.clear();
+  second.clear();
+}
+
+TEST(IntrusiveList, CopyDoesNotCopyLinks) {
+  Connection a(1);
+  ActiveList list;
+  list.push_back(a);
+  Connection copy(a);
+  EXPECT_FALSE(copy.active.is_linked());
+  list.clear();
+}
+
+#ifdef MYN_CHECKED_ITERATORS
+TEST(IntrusiveList, SafeLink) {
+  Connection a(1), b(2);
+  ActiveList first;
+  ActiveList second;
+  first.push_back(a);
+  EXPECT_THROW(second.push_back(a), std::logic_error);
+  EXPECT_THROW(second.erase(a), std::logic_error);
+  EXPECT_THROW(first.erase(b), std::logic_error);
+  first.clear();
+}
+#endif
@@ -627,3 +627,82 @@ TEST(Map, Emplace_1) {
   EXPECT_EQ(my_map.at(2.2), "b");
   EXPECT_ANY_THROW(my_map.at(9.9););
 }
+
+TEST(Map, OrderStatistics) {
+  myn::map<std::string, int, true> m{{"d", 4}, {"a", 1}, {"c", 3}, {"b", 2}};
+  m.insert_or_assign("e", 5);
+  EXPECT_EQ(m.nth(2)->first, "c");
+  EXPECT_EQ(m.rank("c"), 2U);
+  EXPECT_EQ(m.rank("bb"), 2U);
+  EXPECT_EQ(m.count_range("b", "e"), 3U);
+  m.erase(m.nth(0));
+  EXPECT_EQ(m.nth(0)->second, 2);
+  EXPECT_EQ(m.rank("e"), 3U);
+}
+
+TEST(Map, RangeScan) {
+  myn::map<int, std::string> m{{5, "e"}, {1, "a"}, {3, "c"}, {7, "g"}};
+  EXPECT_EQ(m.lower_bound(2)->second, "c");
+  EXPECT_EQ(m.upper_bound(3)->first, 5);
+  EXPECT_TRUE(m.equal_range(4).first == m.equal_range(4).second);
+  std::string joined;
+  m.for_each_in_range(3, 7, [&joined](std::pair<int, std::string> &entry) {
+    entry.second += "!";
+    joined += entry.second;
+  });
+  EXPECT_EQ(joined, "c!e!");
+  EXPECT_EQ(m.at(5), "e!");
+}
+
+// Keys compare alone, and of equal keys the first wins, as with insert.
+TEST(Map, BulkBuild) {
+  std::vector<std::pair<int, std::string>> entries{
+      {3, "c"}, {1, "a"}, {3, "x"}, {2, "b"}, {1, "y"}};
+  myn::map<int, std::string> m(entries.begin(), entries.end());
+  ASSERT_EQ(m.size(), 3U);
+  EXPECT_EQ(m.at(1), "a");
+  EXPECT_EQ(m.at(3), "c");
+  std::vector<std::pair<int, std::string>> sorted{{1, "z"}, {4, "d"}};
+  m.assign_sorted(sorted.begin(), sorted.end());
+  EXPECT_EQ(m.size(), 2U);
+  EXPECT_EQ(m.at(1), "z");
+  EXPECT_FALSE(m.contains(3));
+}
+
+TEST(Map, NodeHandles) {
+  myn::map<int, std::string> m{{1, "a"}, {2, "b"}, {3, "c"}};
+  auto node = m.extract(2);
+  ASSERT_FALSE(node.empty());
+  node.value().first = 4;
+  node.value().second = "d";
+  EXPECT_TRUE(m.insert(std::move(node)).inserted);
+  EXPECT_EQ(m.at(4), "d");
+  EXPECT_FALSE(m.contains(2));
+
+  myn::map<int, std::string> other{{1, "x"}, {5, "e"}};
+  m.merge(other);
+  EXPECT_EQ(m.size(), 4U);
+  EXPECT_EQ(m.at(1), "a");
+  EXPECT_EQ(m.at(5), "e");
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(other.at(1), "x");
+}
+
+// Keys alone decide; values come from the first map where both have a key.
+TEST(Map, Algebra) {
+  myn::map<int, std::string> a{{1, "a"}, {2, "b"}, {4, "d"}};
+  myn::map<int, std::string> b{{2, "x"}, {3, "y"}, {4, "z"}};
+  myn::map<int, std::string> both = myn::set_intersection(a, b);
+  EXPECT_EQ(both.size(), 2U);
+  EXPECT_EQ(both.at(2), "b");
+  EXPECT_EQ(both.at(4), "d");
+  myn::map<int, std::string> all = myn::set_union(a, b);
+  EXPECT_EQ(all.size(), 4U);
+  EXPECT_EQ(all.at(3), "y");
+  EXPECT_EQ(all.at(2), "b");
+  EXPECT_EQ(myn::set_difference(b, a).at(3), "y");
+  std::vector<std::pair<int, std::string>> odd;
+  myn::set_symmetric_difference(a, b, std::back_inserter(odd));
+  EXPECT_EQ(odd, (std::vector<std::pair<int, std::string>>{{1, "a"},
+                                                            {3, "y"}}));
+}
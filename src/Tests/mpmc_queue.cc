@@ -0,0 +1,75 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(MpmcQueue, FullAndEmpty) {
+  myn::mpmc_queue<std::string> q(4);
+  EXPECT_EQ(q.capacity(), 4U);
+  std::string value;
+  EXPECT_FALSE(q.try_pop(value));
+  for (int lap = 0; lap < 3; ++lap) {
+    EXPECT_TRUE(q.try_push("a"));
+    std::string b = "b";
+    EXPECT_TRUE(q.try_push(b));
+    EXPECT_TRUE(q.try_emplace(2, 'c'));
+    EXPECT_TRUE(q.try_push(std::string("d")));
+    EXPECT_FALSE(q.try_push("e"));
+    EXPECT_EQ(q.size(), 4U);
+    for (const char *expected : {"a", "b", "cc", "d"}) {
+      ASSERT_TRUE(q.try_pop(value));
+      EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(q.try_pop(value));
+    EXPECT_TRUE(q.empty());
+  }
+}
+
+TEST(MpmcQueue, DestructorDestroysElements) {
+  myn::mpmc_queue<std::string> q(8);
+  for (int i = 0; i < 5; ++i) q.try_push(std::string(100, 'x'));
+  std::string value;
+  q.try_pop(value);
+}
+
+// Producers push every value once; consumers must see each exactly once,
+// and the values of one producer in the order it pushed them.
+TEST(MpmcQueue, ManyProducersManyConsumers) {
+  const int kProducers = 3;
+  const int kConsumers = 3;
+  const int kPerProducer = 50000;
+  myn::mpmc_queue<int> q(64);
+  std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+  std::atomic<int> popped{0};
+  std::atomic<bool> ordered{true};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&q, p] {
+      for (int i = 0; i < kPerProducer; ++i) {
+        while (!q.try_push(p * kPerProducer + i)) std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&] {
+      std::vector<int> last(kProducers, -1);
+      int value;
+      while (popped.load() < kProducers * kPerProducer) {
+        if (!q.try_pop(value)) {
+          std::this_thread::yield();
+          continue;
+        }
+        int producer = value / kPerProducer;
+        if (value <= last[producer]) ordered = false;
+        last[producer] = value;
+        seen[value].fetch_add(1);
+        popped.fetch_add(1);
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_TRUE(ordered.load());
+  for (auto &count : seen) ASSERT_EQ(count.load(), 1);
+}
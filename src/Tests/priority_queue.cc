@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+namespace {
+// Pushes and pops a random mix against std::priority_queue.
+template <size_t Arity>
+void CompareWithStd() {
+  myn::priority_queue<int, myn::vector<int>, std::less<int>, Arity> q;
+  std::priority_queue<int> expected;
+  std::mt19937 rng(Arity);
+  for (int i = 0; i < 5000; ++i) {
+    if (rng() % 3 != 0 || expected.empty()) {
+      int value = static_cast<int>(rng() % 1000);
+      q.push(value);
+      expected.push(value);
+    } else {
+      ASSERT_EQ(q.top(), expected.top());
+      q.pop();
+      expected.pop();
+    }
+    ASSERT_EQ(q.size(), expected.size());
+  }
+  while (!expected.empty()) {
+    ASSERT_EQ(q.top(), expected.top());
+    q.pop();
+    expected.pop();
+  }
+  EXPECT_TRUE(q.empty());
+}
+}  // namespace
+
+TEST(PriorityQueue, MatchesStdForEveryArity) {
+  CompareWithStd<2>();
+  CompareWithStd<3>();
+  CompareWithStd<4>();
+  CompareWithStd<8>();
+}
+
+TEST(PriorityQueue, EmptyThrows) {
+  myn::priority_queue<int> q;
+  EXPECT_THROW(q.top(), std::logic_error);
+  EXPECT_THROW(q.pop(), std::logic_error);
+}
+
+TEST(PriorityQueue, MinHeapWithEmplace) {
+  myn::priority_queue<std::string, myn::vector<std::string>,
+                      std::greater<std::string>, 4>
+      q;
+  q.emplace(3, 'c');
+  q.emplace("a");
+  q.push(std::string("bb"));
+  EXPECT_EQ(q.top(), "a");
+  q.pop();
+  EXPECT_EQ(q.top(), "bb");
+  q.pop();
+  EXPECT_EQ(q.top(), "ccc");
+}
+
+TEST(PriorityQueue, MoveOnlyElements) {
+  auto less = [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) {
+    return *a < *b;
+  };
+  myn::priority_queue<std::unique_ptr<int>, myn::vector<std::unique_ptr<int>>,
+                      decltype(less)>
+      q(less);
+  for (int i : {4, 1, 5, 9, 2, 6}) q.push(std::make_unique<int>(i));
+  EXPECT_EQ(*q.top(), 9);
+  q.pop();
+  EXPECT_EQ(*q.top(), 6);
+}
+
+// Both paths of push_bulk: a large batch into a small heap (rebuilt in
+// place) and a small batch into a large heap (sifted up one by one).
+TEST(PriorityQueue, PushBulk) {
+  std::vector<int> values(1000);
+  for (int i = 0; i < 1000; ++i) values[i] = (i * 7919) % 1000;
+  myn::priority_queue<int, myn::vector<int>, std::less<int>, 4> q{500, 1};
+  q.push_bulk(values.begin(), values.end());
+  q.push_bulk(values.begin(), values.begin() + 10);
+  std::vector<int> expected = values;
+  expected.insert(expected.end(), values.begin(), values.begin() + 10);
+  expected.push_back(500);
+  expected.push_back(1);
+  std::sort(expected.rbegin(), expected.rend());
+  for (int value : expected) {
+    ASSERT_EQ(q.top(), value);
+    q.pop();
+  }
+  EXPECT_TRUE(q.empty());
+
+  myn::priority_queue<int> from_range(values.begin(), values.end());
+  EXPECT_EQ(from_range.size(), 1000U);
+  EXPECT_EQ(from_range.top(), 999);
+  myn::priority_queue<int> from_container(std::less<int>(),
+                                          myn::vector<int>{3, 8, 1});
+  EXPECT_EQ(from_container.top(), 8);
+}
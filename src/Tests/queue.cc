@@ -198,3 +198,61 @@ TEST(QueueTest, Emplace_back_2) {
     count++;
   }
 }
+
+TEST(QueueTest, WrapsAroundWithoutGrowing) {
+  myn::queue<int> q;
+  q.reserve(8);
+  const size_t capacity = q.capacity();
+  int next_out = 0;
+  for (int i = 0; i < 1000; ++i) {
+    q.push(i);
+    if (q.size() == capacity) {
+      for (int j = 0; j < 5; ++j) {
+        ASSERT_EQ(q.front(), next_out++);
+        q.pop();
+      }
+    }
+  }
+  EXPECT_EQ(q.capacity(), capacity);
+  EXPECT_EQ(q.back(), 999);
+  while (!q.empty()) {
+    ASSERT_EQ(q.front(), next_out++);
+    q.pop();
+  }
+  EXPECT_EQ(next_out, 1000);
+}
+
+TEST(QueueTest, GrowsWhileWrapped) {
+  myn::queue<std::string> q;
+  for (int i = 0; i < 6; ++i) q.push(std::to_string(i));
+  for (int i = 0; i < 4; ++i) q.pop();
+  for (int i = 6; i < 40; ++i) q.push(std::to_string(i));
+  myn::queue<std::string> copy(q);
+  for (int i = 4; i < 40; ++i) {
+    ASSERT_EQ(q.front(), std::to_string(i));
+    ASSERT_EQ(copy.front(), std::to_string(i));
+    q.pop();
+    copy.pop();
+  }
+  EXPECT_TRUE(q.empty());
+  EXPECT_TRUE(copy.empty());
+}
+
+TEST(QueueTest, EmplaceAndRvaluePush) {
+  myn::queue<std::pair<int, std::string>> q;
+  q.emplace(1, "one");
+  std::pair<int, std::string> two{2, "two"};
+  q.push(std::move(two));
+  EXPECT_EQ(q.front().second, "one");
+  EXPECT_EQ(q.back().second, "two");
+  q.front().second = "uno";
+  EXPECT_EQ(q.front().second, "uno");
+}
+
+TEST(QueueTest, PushOwnElementWhileGrowing) {
+  myn::queue<std::string> q;
+  q.push("first");
+  while (q.size() != q.capacity()) q.push("filler");
+  q.push(q.front());
+  EXPECT_EQ(q.back(), "first");
+}
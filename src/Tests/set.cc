@@ -1,3 +1,6 @@
+#include <pthread.h>
+
+#include <random>
 #include <set>
 
 #include "main.h"
@@ -173,3 +176,401 @@ TEST(Set, insert_many) {
   EXPECT_EQ(*(r[2].first), *(pr3.first));
   EXPECT_EQ(r[2].second, pr3.second);
 }
+
+// Erasing the maximum and then everything else keeps end() and the
+// iteration order right, and the emptied set takes new keys.
+TEST(Set, EraseMaxUntilEmpty) {
+  myn::set<int> st{-5, -3, -9, -1, -7};
+  EXPECT_FALSE(st.contains(0));
+  st.erase(st.find(-1));
+  EXPECT_EQ(*(--st.end()), -3);
+  st.insert(-2);
+  EXPECT_EQ(*(--st.end()), -2);
+  std::vector<int> keys;
+  for (int key : st) keys.push_back(key);
+  EXPECT_EQ(keys, (std::vector<int>{-9, -7, -5, -3, -2}));
+  while (!st.empty()) st.erase(--st.end());
+  EXPECT_EQ(st.size(), 0U);
+  EXPECT_TRUE(st.begin() == st.end());
+  st.insert(4);
+  st.insert(2);
+  EXPECT_EQ(*st.begin(), 2);
+  EXPECT_EQ(*(--st.end()), 4);
+}
+
+// nth, rank and count_range against a sorted model through random inserts,
+// erases and a merge.
+TEST(Set, OrderStatistics) {
+  myn::set<int, true> st;
+  std::set<int> model;
+  std::mt19937 rng(5);
+  for (int step = 0; step < 3000; ++step) {
+    int key = static_cast<int>(rng() % 500);
+    if (rng() % 3 != 0) {
+      st.insert(key);
+      model.insert(key);
+    } else if (st.contains(key)) {
+      st.erase(st.find(key));
+      model.erase(key);
+    }
+  }
+  myn::set<int, true> other{-3, 250, 251, 1000};
+  st.merge(other);
+  model.insert({-3, 250, 251, 1000});
+
+  ASSERT_EQ(st.size(), model.size());
+  size_t k = 0;
+  for (int key : model) {
+    ASSERT_EQ(*st.nth(k), key);
+    ASSERT_EQ(st.rank(key), k);
+    ++k;
+  }
+  EXPECT_TRUE(st.nth(model.size()) == st.end());
+  EXPECT_EQ(st.rank(-100), 0U);
+  EXPECT_EQ(st.rank(5000), model.size());
+  for (int lo = -10; lo < 520; lo += 37) {
+    int hi = lo + 60;
+    size_t expected = std::distance(model.lower_bound(lo),
+                                    model.lower_bound(hi));
+    EXPECT_EQ(st.count_range(lo, hi), expected);
+  }
+  EXPECT_EQ(st.count_range(100, 50), 0U);
+}
+
+TEST(Set, Bounds) {
+  myn::set<int> st{10, 20, 30, 40, 50};
+  EXPECT_EQ(*st.lower_bound(20), 20);
+  EXPECT_EQ(*st.lower_bound(21), 30);
+  EXPECT_EQ(*st.upper_bound(20), 30);
+  EXPECT_EQ(*st.lower_bound(-5), 10);
+  EXPECT_TRUE(st.lower_bound(51) == st.end());
+  EXPECT_TRUE(st.upper_bound(50) == st.end());
+  auto range = st.equal_range(30);
+  EXPECT_EQ(*range.first, 30);
+  EXPECT_EQ(*range.second, 40);
+  range = st.equal_range(35);
+  EXPECT_TRUE(range.first == range.second);
+
+  std::vector<int> seen;
+  st.for_each_in_range(15, 40, [&seen](int key) { seen.push_back(key); });
+  EXPECT_EQ(seen, (std::vector<int>{20, 30}));
+  seen.clear();
+  st.for_each_in_range(0, 100, [&seen](int key) { seen.push_back(key); });
+  EXPECT_EQ(seen.size(), 5U);
+  seen.clear();
+  st.for_each_in_range(41, 50, [&seen](int key) { seen.push_back(key); });
+  EXPECT_TRUE(seen.empty());
+
+  myn::set<int> empty;
+  EXPECT_TRUE(empty.lower_bound(1) == empty.end());
+}
+
+// Sorted, unsorted and parallel builds against the same keys inserted one by
+// one; the balanced shape is checked through rank and erase.
+TEST(Set, BulkBuild) {
+  std::vector<int> sorted;
+  for (int i = 0; i < 1000; ++i) sorted.push_back(i / 2 * 3);
+  myn::set<int, true> st;
+  st.assign_sorted(sorted.begin(), sorted.end());
+  ASSERT_EQ(st.size(), 500U);
+  int expected = 0;
+  for (int key : st) {
+    ASSERT_EQ(key, expected);
+    expected += 3;
+  }
+  EXPECT_EQ(st.rank(300), 100U);
+  EXPECT_EQ(*st.nth(499), 1497);
+  EXPECT_TRUE(++st.find(1497) == st.end());
+
+  for (int key = 0; key < 1500; key += 6) st.erase(st.find(key));
+  st.insert(-1);
+  st.insert(2000);
+  EXPECT_EQ(st.size(), 252U);
+  EXPECT_EQ(*st.begin(), -1);
+  EXPECT_EQ(*--st.end(), 2000);
+  EXPECT_EQ(st.rank(9), 2U);
+
+  std::vector<int> unsorted{3, 1, 2, 5, 4};
+  EXPECT_THROW(st.assign_sorted(unsorted.begin(), unsorted.end()),
+               std::invalid_argument);
+  EXPECT_EQ(st.size(), 252U);
+
+  std::vector<int> shuffled;
+  std::mt19937 rng(3);
+  for (int i = 0; i < 5000; ++i) shuffled.push_back(rng() % 2000);
+  std::set<int> model(shuffled.begin(), shuffled.end());
+  myn::set<int> serial(shuffled.begin(), shuffled.end());
+  myn::thread_pool pool(3);
+  myn::set<int> parallel;
+  parallel.assign(shuffled.begin(), shuffled.end(), pool);
+  std::vector<int> keys(model.begin(), model.end());
+  std::vector<int> serial_keys, parallel_keys;
+  for (int key : serial) serial_keys.push_back(key);
+  for (int key : parallel) parallel_keys.push_back(key);
+  EXPECT_EQ(serial_keys, keys);
+  EXPECT_EQ(parallel_keys, keys);
+
+  parallel.assign(sorted.begin(), sorted.begin());
+  EXPECT_TRUE(parallel.empty());
+  parallel.insert(7);
+  EXPECT_EQ(parallel.size(), 1U);
+}
+
+// Copies of a degenerate chain, a bulk-built tree and an empty set, by
+// construction and by assignment over existing contents.
+TEST(Set, Copy) {
+  myn::set<int, true> chain;
+  for (int i = 0; i < 3000; ++i) chain.insert(i);
+  myn::set<int, true> copy(chain);
+  ASSERT_EQ(copy.size(), 3000U);
+  int expected = 0;
+  for (int key : copy) ASSERT_EQ(key, expected++);
+  EXPECT_EQ(copy.rank(1234), 1234U);
+  EXPECT_EQ(*copy.nth(2999), 2999);
+  copy.erase(copy.find(2999));
+  EXPECT_EQ(*--copy.end(), 2998);
+  EXPECT_EQ(chain.size(), 3000U);
+  EXPECT_EQ(*--chain.end(), 2999);
+
+  std::vector<int> keys{1, 3, 5, 7, 9, 11};
+  myn::set<int, true> built;
+  built.assign_sorted(keys.begin(), keys.end());
+  copy = built;
+  EXPECT_EQ(copy.size(), 6U);
+  EXPECT_EQ(copy.rank(7), 3U);
+  copy.insert(4);
+  EXPECT_EQ(copy.rank(7), 4U);
+  EXPECT_FALSE(built.contains(4));
+  auto& self = copy;
+  copy = self;
+  EXPECT_EQ(copy.size(), 7U);
+
+  const myn::set<int, true> empty;
+  copy = empty;
+  EXPECT_TRUE(copy.empty());
+  copy.insert(1);
+  EXPECT_EQ(*copy.begin(), 1);
+}
+
+TEST(Set, NodeHandles) {
+  myn::set<int, true> st{5, 1, 9, 3, 7};
+  auto node = st.extract(3);
+  ASSERT_FALSE(node.empty());
+  EXPECT_EQ(node.value(), 3);
+  EXPECT_EQ(st.size(), 4U);
+  EXPECT_FALSE(st.contains(3));
+  EXPECT_TRUE(st.extract(3).empty());
+  EXPECT_THROW(st.extract(st.end()), std::invalid_argument);
+
+  node.value() = 11;
+  auto result = st.insert(std::move(node));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_TRUE(result.node.empty());
+  EXPECT_EQ(*result.position, 11);
+  EXPECT_EQ(*--st.end(), 11);
+  EXPECT_EQ(st.rank(11), 4U);
+
+  node = st.extract(st.find(5));
+  node.value() = 9;
+  result = st.insert(std::move(node));
+  EXPECT_FALSE(result.inserted);
+  EXPECT_EQ(*result.position, 9);
+  ASSERT_FALSE(result.node.empty());
+  EXPECT_EQ(result.node.value(), 9);
+  EXPECT_EQ(st.size(), 4U);
+  EXPECT_FALSE(st.insert(myn::set<int, true>::node_type()).inserted);
+
+  // Nodes of a bulk-built set outlive it in a handle and in another set.
+  std::vector<int> keys{2, 4, 6, 8};
+  myn::set<int> built;
+  built.assign_sorted(keys.begin(), keys.end());
+  myn::set<int> other;
+  other.insert(built.extract(4));
+  auto kept = built.extract(built.begin());
+  built.clear();
+  EXPECT_EQ(kept.value(), 2);
+  EXPECT_EQ(*other.begin(), 4);
+  while (!other.empty()) other.erase(other.begin());
+  EXPECT_TRUE(other.extract(4).empty());
+}
+
+// Merged nodes move over; those whose keys are taken stay behind.
+TEST(Set, MergeTransfers) {
+  myn::set<int, true> st{10, 20, 30};
+  myn::set<int, true> other{5, 20, 25, 30, 40};
+  const int* moved = &*other.find(25);
+  st.merge(other);
+  EXPECT_EQ(st.size(), 6U);
+  EXPECT_EQ(&*st.find(25), moved);
+  EXPECT_EQ(st.rank(40), 5U);
+  EXPECT_EQ(other.size(), 2U);
+  EXPECT_EQ(*other.begin(), 20);
+  EXPECT_EQ(*--other.end(), 30);
+
+  myn::set<int, true> empty;
+  empty.merge(st);
+  EXPECT_EQ(empty.size(), 6U);
+  EXPECT_TRUE(st.empty());
+  other.merge(other);
+  EXPECT_EQ(other.size(), 2U);
+}
+
+// All four operations against the std algorithms, at sizes that take the
+// linear walk and both finger-search paths.
+TEST(Set, Algebra) {
+  std::mt19937 rng(11);
+  for (auto sizes : {std::pair<int, int>{0, 0}, {0, 50}, {300, 400},
+                     {10, 2000}, {2000, 10}, {1, 3000}}) {
+    myn::set<int> a, b;
+    std::set<int> model_a, model_b;
+    for (int i = 0; i < sizes.first; ++i) {
+      int key = static_cast<int>(rng() % 5000);
+      a.insert(key);
+      model_a.insert(key);
+    }
+    for (int i = 0; i < sizes.second; ++i) {
+      int key = static_cast<int>(rng() % 5000);
+      b.insert(key);
+      model_b.insert(key);
+    }
+    using Op = std::vector<int> (*)(const std::set<int>&, const std::set<int>&);
+    auto check = [&](const myn::set<int>& built, std::vector<int> got,
+                     Op expected) {
+      std::vector<int> want = expected(model_a, model_b);
+      EXPECT_EQ(got, want);
+      std::vector<int> keys;
+      for (int key : built) keys.push_back(key);
+      EXPECT_EQ(keys, want);
+      EXPECT_EQ(built.size(), want.size());
+    };
+    std::vector<int> got;
+    myn::set_union(a, b, std::back_inserter(got));
+    check(myn::set_union(a, b), got,
+          [](const std::set<int>& x, const std::set<int>& y) {
+            std::vector<int> r;
+            std::set_union(x.begin(), x.end(), y.begin(), y.end(),
+                           std::back_inserter(r));
+            return r;
+          });
+    got.clear();
+    myn::set_intersection(a, b, std::back_inserter(got));
+    check(myn::set_intersection(a, b), got,
+          [](const std::set<int>& x, const std::set<int>& y) {
+            std::vector<int> r;
+            std::set_intersection(x.begin(), x.end(), y.begin(), y.end(),
+                                  std::back_inserter(r));
+            return r;
+          });
+    got.clear();
+    myn::set_difference(a, b, std::back_inserter(got));
+    check(myn::set_difference(a, b), got,
+          [](const std::set<int>& x, const std::set<int>& y) {
+            std::vector<int> r;
+            std::set_difference(x.begin(), x.end(), y.begin(), y.end(),
+                                std::back_inserter(r));
+            return r;
+          });
+    got.clear();
+    myn::set_symmetric_difference(a, b, std::back_inserter(got));
+    check(myn::set_symmetric_difference(a, b), got,
+          [](const std::set<int>& x, const std::set<int>& y) {
+            std::vector<int> r;
+            std::set_symmetric_difference(x.begin(), x.end(), y.begin(),
+                                          y.end(), std::back_inserter(r));
+            return r;
+          });
+  }
+}
+
+// The in-order chain behind the iterators, forwards and backwards, through
+// every way of linking and unlinking nodes.
+TEST(Set, IterationChain) {
+  myn::set<int> st;
+  std::set<int> model;
+  auto check = [&](const myn::set<int>& s) {
+    std::vector<int> forward, backward;
+    for (int key : s) forward.push_back(key);
+    if (!s.empty()) {
+      auto it = s.end();
+      do {
+        backward.push_back(*--it);
+      } while (it != s.begin());
+    }
+    std::reverse(backward.begin(), backward.end());
+    std::vector<int> expected(model.begin(), model.end());
+    ASSERT_EQ(forward, expected);
+    ASSERT_EQ(backward, expected);
+  };
+  std::mt19937 rng(17);
+  for (int step = 0; step < 2000; ++step) {
+    int key = static_cast<int>(rng() % 300);
+    if (rng() % 2 == 0) {
+      st.insert(key);
+      model.insert(key);
+    } else if (st.contains(key)) {
+      st.erase(st.find(key));
+      model.erase(key);
+    }
+    if (step % 100 == 0) check(st);
+  }
+  check(st);
+  check(myn::set<int>(st));
+  auto node = st.extract(*st.begin());
+  model.erase(node.value());
+  check(st);
+  myn::set<int> other{-5, 1000};
+  st.merge(other);
+  model.insert({-5, 1000});
+  check(st);
+  std::vector<int> keys{1, 2, 3};
+  st.assign_sorted(keys.begin(), keys.end());
+  model = {1, 2, 3};
+  check(st);
+  st.insert(0);
+  st.insert(4);
+  model.insert({0, 4});
+  check(st);
+  while (!st.empty()) st.erase(--st.end());
+  model.clear();
+  check(st);
+}
+
+// A chain as deep as the set is large, searched, copied and destroyed on a
+// thread with a 128 KiB stack, which recursion over the depth would
+// overflow many times over.
+TEST(Set, DegenerateTreeOnSmallStack) {
+  struct Job {
+    int depth = 20000;
+    bool found = false;
+    size_t copied = 0;
+  } job;
+  auto run = [](void* arg) -> void* {
+    Job* job = static_cast<Job*>(arg);
+    myn::set<int> chain;
+    for (int key = 0; key < job->depth; ++key) chain.insert(key);
+    job->found = chain.contains(job->depth - 1) && !chain.contains(-1);
+    myn::set<int> copy(chain);
+    copy.erase(copy.find(job->depth / 2));
+    job->copied = copy.size();
+    return nullptr;
+  };
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, 128 * 1024);
+  pthread_t thread;
+  ASSERT_EQ(pthread_create(&thread, &attr, run, &job), 0);
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+  EXPECT_TRUE(job.found);
+  EXPECT_EQ(job.copied, static_cast<size_t>(job.depth - 1));
+}
+
+TEST(Set, DefaultIteratorThrows) {
+  myn::set<int> st{1, 2};
+  myn::set<int>::iterator it;
+  EXPECT_THROW(*it, std::invalid_argument);
+  EXPECT_THROW(++it, std::invalid_argument);
+  EXPECT_THROW(--it, std::invalid_argument);
+  EXPECT_THROW(st.erase(it), std::invalid_argument);
+  EXPECT_EQ(st.size(), 2U);
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(SpscQueue, FullAndEmpty) {
+  myn::spsc_queue<std::string> q(3);
+  EXPECT_EQ(q.capacity(), 4U);
+  EXPECT_TRUE(q.empty());
+  std::string value;
+  EXPECT_FALSE(q.try_pop(value));
+  EXPECT_TRUE(q.try_push("a"));
+  std::string b = "b";
+  EXPECT_TRUE(q.try_push(b));
+  EXPECT_TRUE(q.try_emplace(2, 'c'));
+  EXPECT_TRUE(q.try_push(std::string("d")));
+  EXPECT_FALSE(q.try_push("e"));
+  EXPECT_EQ(q.size(), 4U);
+  ASSERT_TRUE(q.try_pop(value));
+  EXPECT_EQ(value, "a");
+  EXPECT_TRUE(q.try_push("e"));
+  for (const char *expected : {"b", "cc", "d", "e"}) {
+    ASSERT_TRUE(q.try_pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_FALSE(q.try_pop(value));
+}
+
+TEST(SpscQueue, Batches) {
+  myn::spsc_queue<int> q(8);
+  std::vector<int> in{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ(q.push_n(in.begin(), in.size()), 8U);
+  int out[16] = {};
+  EXPECT_EQ(q.pop_n(out, 3), 3U);
+  EXPECT_EQ(out[2], 3);
+  EXPECT_EQ(q.push_n(in.begin() + 8, 2), 2U);
+  EXPECT_EQ(q.pop_n(out, 16), 7U);
+  EXPECT_EQ(out[0], 4);
+  EXPECT_EQ(out[6], 10);
+  EXPECT_EQ(q.pop_n(out, 16), 0U);
+}
+
+TEST(SpscQueue, DestructorDestroysElements) {
+  myn::spsc_queue<std::string> q(16);
+  for (int i = 0; i < 10; ++i) q.try_push(std::string(100, 'x'));
+}
+
+TEST(SpscQueue, TwoThreadsKeepOrder) {
+  const long kItems = 200000;
+  myn::spsc_queue<long> q(1024);
+  std::thread producer([&q] {
+    long next = 0;
+    long batch[7];
+    while (next < kItems) {
+      if (next % 3 == 0) {
+        long n = 0;
+        while (n < 7 && next + n < kItems) {
+          batch[n] = next + n;
+          ++n;
+        }
+        next += static_cast<long>(q.push_n(batch, n));
+      } else if (q.try_push(next)) {
+        ++next;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  long expected = 0;
+  long batch[5];
+  while (expected < kItems) {
+    size_t n = q.pop_n(batch, 5);
+    if (n == 0) std::this_thread::yield();
+    for (size_t i = 0; i < n; ++i) ASSERT_EQ(batch[i], expected++);
+  }
+  producer.join();
+  EXPECT_TRUE(q.empty());
+}
@@ -120,3 +120,107 @@ TEST(Test_stack, stack_test_emplace_front) {
     s1.pop();
   }
 }
+
+TEST(StackTest, TopIsMutable) {
+  myn::stack<std::string> s{"a", "b"};
+  s.top() += "c";
+  EXPECT_EQ(s.top(), "bc");
+  const myn::stack<std::string> &view = s;
+  EXPECT_EQ(view.top(), "bc");
+}
+
+TEST(StackTest, EmplaceAndRvaluePush) {
+  myn::stack<std::pair<int, std::string>> s;
+  s.emplace(1, "one");
+  s.push({2, "two"});
+  EXPECT_EQ(s.top().second, "two");
+  s.pop();
+  EXPECT_EQ(s.top().first, 1);
+}
+
+TEST(StackTest, CopyKeepsOrder) {
+  myn::stack<int> s;
+  for (int i = 0; i < 1000; ++i) s.push(i);
+  myn::stack<int> copy(s);
+  for (int i = 999; i >= 0; --i) {
+    ASSERT_EQ(copy.top(), i);
+    copy.pop();
+  }
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(s.size(), 1000U);
+}
+
+TEST(StackTest, ListContainer) {
+  myn::stack<std::string, myn::list<std::string>> s{"a", "b", "c"};
+  EXPECT_EQ(s.size(), 3U);
+  EXPECT_EQ(s.top(), "c");
+  s.pop();
+  s.emplace(2, 'x');
+  EXPECT_EQ(s.top(), "xx");
+  myn::stack<std::string, myn::list<std::string>> other(s);
+  EXPECT_EQ(other.size(), 3U);
+  EXPECT_EQ(other.top(), "xx");
+}
+
+// The adapter contract, run over both containers the stack documents.
+template <class Stack>
+class StackContainerTest : public ::testing::Test {};
+using StackContainers =
+    ::testing::Types<myn::stack<int>, myn::stack<int, myn::list<int>>>;
+TYPED_TEST_SUITE(StackContainerTest, StackContainers);
+
+TYPED_TEST(StackContainerTest, PushPopAndThrow) {
+  TypeParam s;
+  EXPECT_THROW(s.top(), std::logic_error);
+  EXPECT_THROW(s.pop(), std::logic_error);
+  for (int i = 0; i < 100; ++i) s.push(i);
+  EXPECT_EQ(s.size(), 100U);
+  for (int i = 99; i >= 0; --i) {
+    ASSERT_EQ(s.top(), i);
+    s.pop();
+  }
+  EXPECT_TRUE(s.empty());
+}
+
+TYPED_TEST(StackContainerTest, CopyAndAssign) {
+  TypeParam empty;
+  TypeParam a;
+  TypeParam b{1, 2};
+  a = b;
+  EXPECT_EQ(a.size(), 2U);
+  EXPECT_EQ(a.top(), 2);
+  a.pop();
+  EXPECT_EQ(b.top(), 2);
+  b = empty;
+  EXPECT_TRUE(b.empty());
+  TypeParam c(empty);
+  EXPECT_TRUE(c.empty());
+  c.push(7);
+  EXPECT_EQ(c.top(), 7);
+}
+
+TYPED_TEST(StackContainerTest, MoveAndSwap) {
+  TypeParam a{1, 2, 3};
+  TypeParam b(std::move(a));
+  EXPECT_EQ(b.size(), 3U);
+  EXPECT_TRUE(a.empty());
+  TypeParam c;
+  c = std::move(b);
+  EXPECT_EQ(c.top(), 3);
+  EXPECT_TRUE(b.empty());
+  TypeParam empty;
+  TypeParam d(std::move(empty));
+  EXPECT_TRUE(d.empty());
+  EXPECT_TRUE(empty.empty());
+  c.swap(d);
+  EXPECT_TRUE(c.empty());
+  EXPECT_EQ(d.size(), 3U);
+  c.swap(d);
+  EXPECT_EQ(c.top(), 3);
+  d.push(9);
+  c.swap(d);
+  EXPECT_EQ(c.top(), 9);
+  EXPECT_EQ(d.size(), 3U);
+  d.push(4);
+  EXPECT_EQ(d.top(), 4);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <list>
 #include <vector>
@@ -578,6 +579,76 @@ TEST(list, insert_many) {
   ++it;
 }
 
+TEST(list, insert_many_returns_first) {
+  myn::list<int> l{1, 2, 3};
+  auto it = l.insert_many(l.cend(), 4, 5);
+  ASSERT_EQ(*it, 4);
+  it = l.insert_many(l.cbegin(), 0);
+  ASSERT_EQ(it, l.begin());
+  it = l.insert_many(l.cbegin());
+  ASSERT_EQ(it, l.begin());
+  myn::list<int> empty;
+  it = empty.insert_many(empty.cbegin(), 7, 8);
+  ASSERT_EQ(*it, 7);
+  ASSERT_EQ(empty.back(), 8);
+  ASSERT_EQ(empty.size(), 2);
+  myn::list<int> none;
+  it = none.insert_many(none.cbegin());
+  ASSERT_EQ(it, none.end());
+  ASSERT_TRUE(none.empty());
+}
+
+namespace {
+struct Counted {
+  static int constructed;
+  Counted() { ++constructed; }
+  Counted(int v) : value(v) { ++constructed; }
+  Counted(const Counted &other) : value(other.value) { ++constructed; }
+  Counted(Counted &&other) noexcept : value(other.value) { ++constructed; }
+  Counted &operator=(const Counted &) = default;
+  int value = 0;
+};
+int Counted::constructed = 0;
+}  // namespace
+
+TEST(list, insert_many_constructs_only_new) {
+  myn::list<Counted> l;
+  for (int i = 0; i < 1000; ++i) l.emplace_back(i);
+  Counted::constructed = 0;
+  auto pos = l.cbegin();
+  for (int i = 0; i < 500; ++i) ++pos;
+  auto it = l.insert_many(pos, 1, 2, 3);
+  ASSERT_EQ(Counted::constructed, 3);
+  ASSERT_EQ((*it).value, 1);
+  ASSERT_EQ(l.size(), 1003);
+}
+
+TEST(list, emplace) {
+  myn::list<std::pair<int, std::string>> l;
+  l.emplace_back(2, "two");
+  l.emplace_front(0, "zero");
+  auto it = l.emplace(++l.cbegin(), 1, "one");
+  ASSERT_EQ((*it).second, "one");
+  ASSERT_EQ(l.front().first, 0);
+  ASSERT_EQ(l.back().first, 2);
+  auto &ref = l.emplace_back(3, "three");
+  ref.second = "drei";
+  ASSERT_EQ(l.back().second, "drei");
+}
+
+TEST(list, push_rvalue) {
+  myn::list<std::unique_ptr<int>> l;
+  l.push_back(std::make_unique<int>(2));
+  l.push_front(std::make_unique<int>(1));
+  l.insert(l.end(), std::make_unique<int>(3));
+  int expected = 1;
+  for (auto it = l.begin(); it != l.end(); ++it) ASSERT_EQ(**it, expected++);
+  std::string s = "moved";
+  myn::list<std::string> strings;
+  strings.push_back(std::move(s));
+  ASSERT_EQ(strings.front(), "moved");
+}
+
 TEST(list, insert_many_back) {
   myn::list<int> l{1, 2, 3};
   l.insert_many_back(4, 5, 6, 7, 8, 9);
@@ -598,6 +669,236 @@ TEST(list, insert_many_front) {
   }
 }
 
+TEST(list, pool_reuses_nodes) {
+  auto pool = std::make_shared<myn::list<int>::pool_type>();
+  myn::list<int> l(pool);
+  for (int i = 0; i < 100; ++i) l.push_back(i);
+  auto capacity = pool->capacity();
+  for (int i = 0; i < 1000; ++i) {
+    l.pop_front();
+    l.push_back(i);
+  }
+  ASSERT_EQ(pool->capacity(), capacity);
+  ASSERT_EQ(l.size(), 100);
+  ASSERT_EQ(l.front(), 900);
+  ASSERT_EQ(l.back(), 999);
+}
+
+TEST(list, pool_shared) {
+  auto pool = std::make_shared<myn::list<std::string>::pool_type>();
+  myn::list<std::string> a(pool);
+  myn::list<std::string> b(pool);
+  for (int i = 0; i < 50; ++i) {
+    a.push_back(std::to_string(i));
+    b.push_front(std::to_string(i));
+  }
+  a.clear();
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(b.size(), 50);
+  ASSERT_EQ(b.front(), "49");
+  ASSERT_EQ(b.back(), "0");
+  auto capacity = pool->capacity();
+  for (int i = 0; i < 50; ++i) a.push_back("x");
+  ASSERT_EQ(pool->capacity(), capacity);
+}
+
+TEST(list, clear_reuse) {
+  myn::list<int> l{1, 2, 3};
+  l.clear();
+  l.push_back(4);
+  l.push_front(5);
+  ASSERT_EQ(l.size(), 2);
+  ASSERT_EQ(l.front(), 5);
+  ASSERT_EQ(l.back(), 4);
+}
+
+namespace {
+template <typename T>
+bool ListEquals(myn::list<T> &l, std::initializer_list<T> expected) {
+  if (l.size() != expected.size()) return false;
+  auto it = l.begin();
+  for (const auto &value : expected) {
+    if (!(*it == value)) return false;
+    ++it;
+  }
+  return true;
+}
+}  // namespace
+
+TEST(list, splice_element) {
+  myn::list<int> a{1, 2, 3};
+  myn::list<int> b{10, 20, 30};
+  a.splice(++a.cbegin(), b, ++b.cbegin());
+  ASSERT_TRUE(ListEquals(a, {1, 20, 2, 3}));
+  ASSERT_TRUE(ListEquals(b, {10, 30}));
+  ASSERT_EQ(a.size(), 4);
+  ASSERT_EQ(b.size(), 2);
+  ASSERT_EQ(a.back(), 3);
+}
+
+TEST(list, splice_range) {
+  myn::list<int> a{1, 2, 3};
+  myn::list<int> b{10, 20, 30, 40};
+  auto last = b.cend();
+  --last;
+  a.splice(a.cend(), b, ++b.cbegin(), last);
+  ASSERT_TRUE(ListEquals(a, {1, 2, 3, 20, 30}));
+  ASSERT_EQ(a.size(), 5);
+  ASSERT_EQ(a.back(), 30);
+  ASSERT_EQ(b.size(), 2);
+  ASSERT_EQ(b.front(), 10);
+  ASSERT_EQ(b.back(), 40);
+}
+
+TEST(list, splice_same_list) {
+  myn::list<int> a{1, 2, 3, 4, 5};
+  auto first = a.cbegin();
+  auto last = ++(++a.cbegin());
+  a.splice(a.cend(), a, first, last);
+  ASSERT_TRUE(ListEquals(a, {3, 4, 5, 1, 2}));
+  ASSERT_EQ(a.size(), 5);
+  ASSERT_EQ(a.front(), 3);
+  ASSERT_EQ(a.back(), 2);
+}
+
+TEST(list, splice_into_empty) {
+  myn::list<int> a;
+  myn::list<int> b{1, 2, 3};
+  a.splice(a.cbegin(), b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(a.size(), 3);
+  ASSERT_EQ(a.front(), 1);
+  ASSERT_EQ(a.back(), 3);
+  b.push_back(4);
+  b.splice(b.cend(), a, a.cbegin());
+  ASSERT_EQ(b.front(), 4);
+  ASSERT_EQ(b.back(), 1);
+  ASSERT_EQ(a.front(), 2);
+}
+
+TEST(list, splice_between_shared_pools) {
+  auto pool_a = std::make_shared<myn::list<int>::pool_type>();
+  auto pool_b = std::make_shared<myn::list<int>::pool_type>();
+  myn::list<int> a(pool_a);
+  myn::list<int> b(pool_b);
+  myn::list<int> third_a(pool_a);
+  myn::list<int> third_b(pool_b);
+  a.push_back(1);
+  b.push_back(2);
+  b.push_back(3);
+  third_a.push_back(10);
+  third_b.push_back(20);
+  const int *two = &*b.begin();
+  const int *three = &*++b.begin();
+  a.splice(a.cend(), b);
+  ASSERT_TRUE(ListEquals(a, {1, 2, 3}));
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(&*++a.begin(), two);
+  ASSERT_EQ(&*++(++a.begin()), three);
+  third_b.push_back(21);
+  b.push_back(4);
+  a.merge(third_b);
+  ASSERT_TRUE(ListEquals(a, {1, 2, 3, 20, 21}));
+  ASSERT_TRUE(ListEquals(third_a, {10}));
+  ASSERT_TRUE(ListEquals(b, {4}));
+}
+
+TEST(list, merged_pool_keeps_free_slots) {
+  auto pool_a = std::make_shared<myn::list<int>::pool_type>();
+  auto pool_b = std::make_shared<myn::list<int>::pool_type>();
+  myn::list<int> a(pool_a);
+  myn::list<int> b(pool_b);
+  for (int i = 0; i < 4; ++i) {
+    a.push_back(i);
+    b.push_back(i);
+  }
+  b.pop_back();
+  auto capacity = pool_a->capacity() + pool_b->capacity();
+  a.splice(a.cend(), b);
+  ASSERT_EQ(pool_a->capacity(), capacity);
+  for (size_t i = a.size(); i < capacity; ++i) a.push_back(0);
+  ASSERT_EQ(pool_a->capacity(), capacity);
+  ASSERT_EQ(a.size(), capacity);
+}
+
+TEST(list, splice_and_merge_move_only) {
+  myn::list<std::unique_ptr<int>> a;
+  myn::list<std::unique_ptr<int>> b;
+  a.push_back(std::make_unique<int>(1));
+  b.push_back(std::make_unique<int>(2));
+  b.push_back(std::make_unique<int>(3));
+  int *two = b.front().get();
+  a.splice(a.cend(), b, b.cbegin());
+  ASSERT_EQ(a.back().get(), two);
+  ASSERT_EQ(b.size(), 1);
+  a.merge(b);
+  ASSERT_EQ(a.size(), 3);
+  ASSERT_TRUE(b.empty());
+}
+
+TEST(list, merge_moves_nodes) {
+  myn::list<int> a{1, 3, 5};
+  myn::list<int> b{0, 3, 4, 9};
+  a.merge(b);
+  ASSERT_TRUE(ListEquals(a, {0, 1, 3, 3, 4, 5, 9}));
+  ASSERT_EQ(a.size(), 7);
+  ASSERT_EQ(a.back(), 9);
+  ASSERT_TRUE(b.empty());
+  b.push_back(1);
+  ASSERT_EQ(b.front(), 1);
+}
+
+namespace {
+struct Keyed {
+  int key;
+  int order;
+  bool operator<(const Keyed &other) const { return key < other.key; }
+};
+}  // namespace
+
+TEST(list, sort_stable) {
+  myn::list<Keyed> l;
+  for (int i = 0; i < 100; ++i) l.push_back({(i * 7) % 5, i});
+  l.sort();
+  auto prev = *l.begin();
+  for (auto it = ++l.begin(); it != l.end(); ++it) {
+    ASSERT_TRUE(prev.key < (*it).key ||
+                (prev.key == (*it).key && prev.order < (*it).order));
+    prev = *it;
+  }
+}
+
+TEST(list, sort_large) {
+  myn::list<int> l;
+  std::vector<int> expected;
+  for (int i = 0; i < 10000; ++i) {
+    int value = (i * 7919) % 10007;
+    l.push_back(value);
+    expected.push_back(value);
+  }
+  l.sort();
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(l.size(), expected.size());
+  auto it = l.begin();
+  for (int value : expected) {
+    ASSERT_EQ(*it, value);
+    ++it;
+  }
+  ASSERT_EQ(l.back(), expected.back());
+  int count = 0;
+  for (it = --l.end(); it != l.begin(); --it) ++count;
+  ASSERT_EQ(count, 9999);
+}
+
+TEST(list, reverse_back) {
+  myn::list<int> a{1, 2, 3};
+  a.reverse();
+  ASSERT_EQ(a.front(), 3);
+  ASSERT_EQ(a.back(), 1);
+  a.push_back(0);
+  ASSERT_EQ(a.back(), 0);
+}
+
 TEST(stack, base) {
   myn::stack<int> s;
   s.push(123);
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+TEST(WorkStealingDeque, OwnerLifoThiefFifo) {
+  myn::work_stealing_deque<int> d(2);
+  int value = 0;
+  EXPECT_FALSE(d.pop(value));
+  EXPECT_FALSE(d.steal(value));
+  for (int i = 0; i < 100; ++i) d.push(i);
+  EXPECT_EQ(d.size(), 100U);
+  ASSERT_TRUE(d.pop(value));
+  EXPECT_EQ(value, 99);
+  ASSERT_TRUE(d.steal(value));
+  EXPECT_EQ(value, 0);
+  ASSERT_TRUE(d.steal(value));
+  EXPECT_EQ(value, 1);
+  for (int i = 98; i >= 2; --i) {
+    ASSERT_TRUE(d.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(d.empty());
+  EXPECT_FALSE(d.pop(value));
+}
+
+// The owner pushes and pops while thieves steal; every element is taken
+// exactly once.
+TEST(WorkStealingDeque, ConcurrentSteal) {
+  const int kItems = 200000;
+  const int kThieves = 3;
+  myn::work_stealing_deque<int> d(4);
+  std::vector<std::atomic<int>> taken(kItems);
+  std::atomic<int> count{0};
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < kThieves; ++t) {
+    thieves.emplace_back([&] {
+      int value;
+      while (count.load() < kItems) {
+        if (d.steal(value)) {
+          taken[value].fetch_add(1);
+          count.fetch_add(1);
+        }
+      }
+    });
+  }
+  int value;
+  for (int i = 0; i < kItems; ++i) {
+    d.push(i);
+    if (i % 3 == 0 && d.pop(value)) {
+      taken[value].fetch_add(1);
+      count.fetch_add(1);
+    }
+  }
+  while (d.pop(value)) {
+    taken[value].fetch_add(1);
+    count.fetch_add(1);
+  }
+  for (auto &thief : thieves) thief.join();
+  for (auto &t : taken) ASSERT_EQ(t.load(), 1);
+}
+
+TEST(ThreadPool, SubmitAndWait) {
+  myn::thread_pool pool(4);
+  EXPECT_EQ(pool.size(), 4U);
+  std::atomic<int> sum{0};
+  for (int i = 1; i <= 1000; ++i) {
+    pool.submit([&sum, i] { sum.fetch_add(i); });
+  }
+  pool.wait();
+  EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(ThreadPool, TasksSubmitTasks) {
+  myn::thread_pool pool(3);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.submit([&pool, &count] {
+      for (int j = 0; j < 10; ++j) pool.submit([&count] { ++count; });
+    });
+  }
+  pool.wait();
+  EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPool, ParallelForCoversRangeOnce) {
+  myn::thread_pool pool(4);
+  std::vector<std::atomic<int>> hits(100003);
+  pool.parallel_for(0L, 100003L, 1000L, [&hits](long lo, long hi) {
+    EXPECT_LE(hi - lo, 1000);
+    for (long i = lo; i < hi; ++i) hits[i].fetch_add(1);
+  });
+  for (auto &hit : hits) ASSERT_EQ(hit.load(), 1);
+}
+
+TEST(ThreadPool, NestedParallelFor) {
+  myn::thread_pool pool(4);
+  std::atomic<long> sum{0};
+  pool.parallel_for(0, 64, 1, [&pool, &sum](int lo, int hi) {
+    for (int i = lo; i < hi; ++i) {
+      pool.parallel_for(0, 1000, 10, [&sum, i](int a, int b) {
+        long local = 0;
+        for (int j = a; j < b; ++j) local += i * 1000 + j;
+        sum.fetch_add(local);
+      });
+    }
+  });
+  EXPECT_EQ(sum.load(), 64000L * 63999 / 2);
+}
+
+TEST(ThreadPool, ParallelSetSum) {
+  myn::set<int> set;
+  for (int i = 0; i < 20000; ++i) set.insert((i * 7919) % 20000);
+  myn::thread_pool pool(4);
+  std::atomic<long> sum{0};
+  // Keys are exactly 0..n-1, so a key range starts at find(lo).
+  pool.parallel_for(0, 20000, 500, [&set, &sum](int lo, int hi) {
+    long local = 0;
+    auto it = set.find(lo);
+    for (int key = lo; key < hi; ++key, ++it) local += *it;
+    sum.fetch_add(local);
+  });
+  EXPECT_EQ(sum.load(), 20000L * 19999 / 2);
+}
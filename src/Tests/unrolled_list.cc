@@ -0,0 +1,169 @@
+#include <list>
+#include <random>
+#include <string>
+
+#include "main.h"
+
+namespace {
+template <class T, std::size_t N>
+bool SameAs(myn::unrolled_list<T, N> &unrolled, const std::list<T> &expected) {
+  if (unrolled.size() != expected.size()) return false;
+  auto it = unrolled.begin();
+  for (const auto &value : expected) {
+    if (it == unrolled.end() || !(*it == value)) return false;
+    ++it;
+  }
+  return it == unrolled.end();
+}
+
+// Elements of one node are contiguous, so each break in the addresses
+// starts a new node.
+template <class T, std::size_t N>
+std::size_t NodeCount(myn::unrolled_list<T, N> &unrolled) {
+  std::size_t nodes = 0;
+  const T *last = nullptr;
+  for (auto &value : unrolled) {
+    if (&value != last + 1) ++nodes;
+    last = &value;
+  }
+  return nodes;
+}
+}  // namespace
+
+TEST(UnrolledList, Empty) {
+  myn::unrolled_list<int> l;
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(l.size(), 0U);
+  EXPECT_EQ(l.begin(), l.end());
+  EXPECT_THROW(l.front(), std::logic_error);
+  EXPECT_THROW(l.pop_back(), std::logic_error);
+}
+
+TEST(UnrolledList, PushAndPop) {
+  myn::unrolled_list<int, 4> l;
+  std::list<int> expected;
+  for (int i = 0; i < 10; ++i) {
+    l.push_back(i);
+    expected.push_back(i);
+    l.push_front(-i);
+    expected.push_front(-i);
+  }
+  EXPECT_TRUE(SameAs(l, expected));
+  EXPECT_EQ(l.front(), -9);
+  EXPECT_EQ(l.back(), 9);
+  for (int i = 0; i < 5; ++i) {
+    l.pop_back();
+    expected.pop_back();
+    l.pop_front();
+    expected.pop_front();
+  }
+  EXPECT_TRUE(SameAs(l, expected));
+}
+
+TEST(UnrolledList, InitListAndCopy) {
+  myn::unrolled_list<std::string, 2> l{"a", "b", "c", "d", "e"};
+  myn::unrolled_list<std::string, 2> copy(l);
+  EXPECT_TRUE(SameAs(copy, {"a", "b", "c", "d", "e"}));
+  myn::unrolled_list<std::string, 2> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(SameAs(moved, {"a", "b", "c", "d", "e"}));
+  copy = l;
+  EXPECT_TRUE(SameAs(copy, {"a", "b", "c", "d", "e"}));
+}
+
+TEST(UnrolledList, BackwardIteration) {
+  myn::unrolled_list<int, 3> l{1, 2, 3, 4, 5, 6, 7};
+  int expected = 7;
+  for (auto it = l.end(); it != l.begin();) {
+    --it;
+    EXPECT_EQ(*it, expected--);
+  }
+  EXPECT_EQ(expected, 0);
+}
+
+TEST(UnrolledList, InsertInMiddle) {
+  myn::unrolled_list<int, 4> l{1, 2, 3, 4};
+  auto it = l.begin();
+  ++it;
+  ++it;
+  it = l.insert(it, 10);
+  EXPECT_EQ(*it, 10);
+  it = l.insert(it, 11);
+  EXPECT_EQ(*it, 11);
+  EXPECT_TRUE(SameAs(l, {1, 2, 11, 10, 3, 4}));
+}
+
+TEST(UnrolledList, RandomInsertErase) {
+  myn::unrolled_list<int, 8> l;
+  std::list<int> expected;
+  std::mt19937 gen(7);
+  for (int step = 0; step < 5000; ++step) {
+    std::size_t index = expected.empty() ? 0 : gen() % (expected.size() + 1);
+    auto it = l.begin();
+    auto expected_it = expected.begin();
+    for (std::size_t i = 0; i < index; ++i, ++it, ++expected_it) {
+    }
+    if (gen() % 3 != 0 || expected_it == expected.end()) {
+      it = l.insert(it, step);
+      expected_it = expected.insert(expected_it, step);
+    } else {
+      it = l.erase(it);
+      expected_it = expected.erase(expected_it);
+    }
+    if (expected_it == expected.end()) {
+      ASSERT_EQ(it, l.end());
+    } else {
+      ASSERT_EQ(*it, *expected_it);
+    }
+  }
+  EXPECT_TRUE(SameAs(l, expected));
+  while (!expected.empty()) {
+    auto it = l.begin();
+    auto expected_it = expected.begin();
+    for (std::size_t i = 0; i < expected.size() / 2; ++i, ++it, ++expected_it) {
+    }
+    it = l.erase(it);
+    expected.erase(expected_it);
+  }
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(l.begin(), l.end());
+}
+
+TEST(UnrolledList, EraseKeepsNodesHalfFull) {
+  myn::unrolled_list<int, 8> l;
+  std::list<int> expected;
+  for (int i = 0; i < 64; ++i) {
+    l.push_back(i);
+    expected.push_back(i);
+  }
+  // Leave N / 4 + 1 elements of every eight, which a merge that needs both
+  // nodes to fit in half a node would never compact.
+  auto it = l.begin();
+  for (int i = 0; i < 64; ++i) {
+    if (i % 8 >= 3) {
+      it = l.erase(it);
+      expected.remove(i);
+      ASSERT_TRUE(it == l.end() || *it == i + 1);
+    } else {
+      ++it;
+    }
+  }
+  EXPECT_TRUE(SameAs(l, expected));
+  EXPECT_LE(NodeCount(l), l.size() / 4 + 1);
+  // Erasing next to the tail borrows from or merges with the previous node.
+  while (l.size() > 1) {
+    int last = l.back();
+    it = l.erase(std::prev(l.end(), 2));
+    ASSERT_EQ(*it, last);
+    ASSERT_LE(NodeCount(l), l.size() / 4 + 1);
+  }
+  EXPECT_EQ(l.front(), 58);
+}
+
+TEST(UnrolledList, Emplace) {
+  myn::unrolled_list<std::pair<int, std::string>> l;
+  l.emplace(l.end(), 1, "one");
+  l.emplace(l.begin(), 0, "zero");
+  EXPECT_EQ(l.front().second, "zero");
+  EXPECT_EQ(l.back().first, 1);
+}
@@ -1,12 +1,24 @@
 #ifndef SRC_CONTAINERS_H_
 #define SRC_CONTAINERS_H_
 
+#include "include/blocking_queue.h"
+#include "include/channel.h"
+#include "include/concurrent_map.h"
+#include "include/concurrent_stack.h"
+#include "include/indexed_priority_queue.h"
+#include "include/intrusive_list.h"
 #include "include/list.h"
 #include "include/map.h"
+#include "include/mpmc_queue.h"
+#include "include/priority_queue.h"
 #include "include/queue.h"
 #include "include/set.h"
+#include "include/spsc_queue.h"
 #include "include/stack.h"
+#include "include/thread_pool.h"
+#include "include/unrolled_list.h"
 #include "include/vector.h"
+#include "include/work_stealing_deque.h"
 
 #include "include/array.h"
 
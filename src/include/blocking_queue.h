@@ -0,0 +1,230 @@
+#ifndef SRC_INCLUDE_BLOCKING_QUEUE_H_
+#define SRC_INCLUDE_BLOCKING_QUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include "queue.h"
+
+namespace myn {
+// FIFO queue shared by any number of producer and consumer threads, where a
+// consumer sleeps until there is something to pop instead of polling. With
+// a capacity, push sleeps while the queue is full, so fast producers are
+// held back to the pace of the consumers.
+//
+// pop_bulk takes everything up to a limit under one lock acquisition, which
+// spreads the cost of the lock and of the wakeup over the whole batch.
+//
+// close() is for shutdown: pushes fail from then on, and pops keep draining
+// what is left and fail once the queue is empty, instead of sleeping.
+// Sleeping threads are woken by it.
+template <typename T>
+class blocking_queue {
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+  // A capacity of 0 means unbounded.
+  explicit blocking_queue(size_type capacity = 0) : capacity_(capacity) {
+    if (capacity_ != 0) queue_.reserve(capacity_);
+  }
+  blocking_queue(const blocking_queue &) = delete;
+  blocking_queue &operator=(const blocking_queue &) = delete;
+
+  size_type capacity() const noexcept { return capacity_; }
+  // Snapshots while other threads are pushing or popping.
+  size_type size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+  bool empty() const { return size() == 0; }
+  bool closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+  }
+
+  // Block while the queue is full. Return false, leaving the value alone,
+  // if the queue is closed.
+  bool push(const_reference value) { return emplace(value); }
+  bool push(value_type &&value) { return emplace(std::move(value)); }
+  template <typename... Args>
+  bool emplace(Args &&...args);
+  // Returns false if the queue is full or closed.
+  bool try_push(const_reference value) { return try_emplace(value); }
+  bool try_push(value_type &&value) { return try_emplace(std::move(value)); }
+  template <typename... Args>
+  bool try_emplace(Args &&...args);
+
+  // Blocks while the queue is empty. Returns false once the queue is closed
+  // and empty.
+  bool pop(reference value);
+  // Returns false if the queue is empty.
+  bool try_pop(reference value);
+  // Like pop, but gives up and returns false once timeout has passed (or
+  // deadline is reached).
+  template <class Rep, class Period>
+  bool try_pop_for(reference value,
+                   const std::chrono::duration<Rep, Period> &timeout) {
+    return try_pop_until(value, std::chrono::steady_clock::now() + timeout);
+  }
+  template <class Clock, class Duration>
+  bool try_pop_until(reference value,
+                     const std::chrono::time_point<Clock, Duration> &deadline);
+  // Blocks while the queue is empty, then pops up to max elements into out.
+  // Returns how many it popped: 0 only once the queue is closed and empty
+  // (or if max is 0).
+  template <class OutputIt>
+  size_type pop_bulk(OutputIt out, size_type max);
+
+  // Idempotent.
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+ private:
+  bool full() const { return capacity_ != 0 && queue_.size() >= capacity_; }
+
+  // Moves up to max elements out; mutex_ must be held. Returns the count.
+  template <class OutputIt>
+  size_type take(OutputIt out, size_type max) {
+    size_type n = 0;
+    for (; n < max && !queue_.empty(); ++n, ++out) {
+      *out = std::move(queue_.front());
+      queue_.pop();
+    }
+    return n;
+  }
+
+  // Called after the lock is released, so the woken thread does not wake
+  // straight into a held mutex. Waiters are counted to skip the system call
+  // when nobody sleeps, which is the common case under load.
+  void wake_consumers(bool any_waiting, size_type pushed) {
+    if (!any_waiting) return;
+    if (pushed == 1) {
+      not_empty_.notify_one();
+    } else {
+      not_empty_.notify_all();
+    }
+  }
+  void wake_producers(bool any_waiting, size_type popped) {
+    if (!any_waiting || popped == 0) return;
+    if (popped == 1) {
+      not_full_.notify_one();
+    } else {
+      not_full_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  queue<T> queue_;
+  size_type capacity_;
+  size_type waiting_consumers_ = 0;
+  size_type waiting_producers_ = 0;
+  bool closed_ = false;
+};
+
+template <typename T>
+template <typename... Args>
+bool blocking_queue<T>::emplace(Args &&...args) {
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (full() && !closed_) {
+      ++waiting_producers_;
+      not_full_.wait(lock, [this] { return closed_ || !full(); });
+      --waiting_producers_;
+    }
+    if (closed_) return false;
+    queue_.emplace(std::forward<Args>(args)...);
+    wake = waiting_consumers_ != 0;
+  }
+  wake_consumers(wake, 1);
+  return true;
+}
+
+template <typename T>
+template <typename... Args>
+bool blocking_queue<T>::try_emplace(Args &&...args) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_ || full()) return false;
+    queue_.emplace(std::forward<Args>(args)...);
+    wake = waiting_consumers_ != 0;
+  }
+  wake_consumers(wake, 1);
+  return true;
+}
+
+template <typename T>
+bool blocking_queue<T>::pop(reference value) {
+  return pop_bulk(&value, 1) == 1;
+}
+
+template <typename T>
+bool blocking_queue<T>::try_pop(reference value) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (take(&value, 1) == 0) return false;
+    wake = waiting_producers_ != 0;
+  }
+  wake_producers(wake, 1);
+  return true;
+}
+
+template <typename T>
+template <class Clock, class Duration>
+bool blocking_queue<T>::try_pop_until(
+    reference value, const std::chrono::time_point<Clock, Duration> &deadline) {
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.empty() && !closed_) {
+      ++waiting_consumers_;
+      not_empty_.wait_until(lock, deadline,
+                            [this] { return closed_ || !queue_.empty(); });
+      --waiting_consumers_;
+    }
+    if (take(&value, 1) == 0) return false;
+    wake = waiting_producers_ != 0;
+  }
+  wake_producers(wake, 1);
+  return true;
+}
+
+template <typename T>
+template <class OutputIt>
+typename blocking_queue<T>::size_type blocking_queue<T>::pop_bulk(
+    OutputIt out, size_type max) {
+  if (max == 0) return 0;
+  size_type popped;
+  bool wake;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.empty() && !closed_) {
+      ++waiting_consumers_;
+      not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+      --waiting_consumers_;
+    }
+    popped = take(out, max);
+    wake = waiting_producers_ != 0;
+  }
+  wake_producers(wake, popped);
+  return popped;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_BLOCKING_QUEUE_H_
@@ -0,0 +1,262 @@
+#ifndef SRC_INCLUDE_CHANNEL_H_
+#define SRC_INCLUDE_CHANNEL_H_
+
+// Coroutine support is a C++20 language feature; GCC also offers it in
+// C++17 mode under -fcoroutines, which the Makefile passes. Without it this
+// header is empty.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "intrusive_list.h"
+#include "queue.h"
+
+namespace myn {
+// Coroutine that starts suspended and runs once handed to an executor. Its
+// frame frees itself when the body returns. The body must not throw.
+class task {
+ public:
+  struct promise_type {
+    task get_return_object() noexcept {
+      return task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  task(task &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  task(const task &) = delete;
+  task &operator=(const task &) = delete;
+  // A task that was never spawned is dropped unrun.
+  ~task() {
+    if (handle_) handle_.destroy();
+  }
+
+ private:
+  friend class executor;
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Single-threaded executor: a FIFO of coroutines ready to run, which run()
+// resumes one at a time on the calling thread until it is empty. A
+// coroutine that another one wakes goes to the back of the FIFO instead of
+// being resumed from inside the waker, so wakeups never nest and the stack
+// stays flat.
+class executor {
+ public:
+  using size_type = size_t;
+
+  executor() {}
+  executor(const executor &) = delete;
+  executor &operator=(const executor &) = delete;
+  // Coroutines still waiting to run are destroyed unrun.
+  ~executor() {
+    while (!ready_.empty()) {
+      ready_.front().destroy();
+      ready_.pop();
+    }
+  }
+
+  void spawn(task &&t) { schedule(std::exchange(t.handle_, nullptr)); }
+  void schedule(std::coroutine_handle<> handle) { ready_.push(handle); }
+
+  // Resumes ready coroutines until none is left; returns how many
+  // resumptions that took.
+  size_type run() {
+    size_type resumed = 0;
+    while (!ready_.empty()) {
+      std::coroutine_handle<> handle = ready_.front();
+      ready_.pop();
+      handle.resume();
+      ++resumed;
+    }
+    return resumed;
+  }
+
+ private:
+  queue<std::coroutine_handle<>> ready_;
+};
+
+// Channel between coroutines on one executor. co_await receive() suspends
+// while the channel is empty and co_await send(value) while it is full;
+// neither blocks the thread. Waiters are woken in the order they started
+// waiting, and a woken coroutine is scheduled on the executor rather than
+// resumed in place.
+//
+// With capacity 0 every send waits for a receiver, which takes the value
+// straight from the sender. Otherwise up to capacity values are buffered in
+// a myn::queue.
+//
+// After close() sends fail (return false), and receives drain what is
+// buffered and then yield an empty optional. Waiting coroutines are woken.
+// A channel must outlive the coroutines suspended on it, so close it and
+// run the executor before destroying it.
+//
+// Not thread-safe: all users must run on the channel's executor.
+template <typename T>
+class channel {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  explicit channel(executor &ex, size_type capacity = 0)
+      : executor_(ex), capacity_(capacity) {}
+  channel(const channel &) = delete;
+  channel &operator=(const channel &) = delete;
+
+  class ReceiveAwaiter {
+   public:
+    ~ReceiveAwaiter() {
+      if (hook_.is_linked()) channel_->receivers_.erase(*this);
+    }
+    bool await_ready() { return channel_->take(value_); }
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_->receivers_.push_back(*this);
+    }
+    // Empty once the channel is closed and drained.
+    std::optional<T> await_resume() { return std::move(value_); }
+
+   private:
+    friend class channel;
+    explicit ReceiveAwaiter(channel *ch) : channel_(ch) {}
+
+    channel *channel_;
+    std::optional<T> value_;
+    std::coroutine_handle<> handle_;
+    intrusive_list_hook hook_;
+  };
+
+  class SendAwaiter {
+   public:
+    ~SendAwaiter() {
+      if (hook_.is_linked()) channel_->senders_.erase(*this);
+    }
+    bool await_ready() { return channel_->put(value_, sent_); }
+    void await_suspend(std::coroutine_handle<> handle) {
+      handle_ = handle;
+      channel_->senders_.push_back(*this);
+    }
+    // False if the channel was closed before the value got in.
+    bool await_resume() const noexcept { return sent_; }
+
+   private:
+    friend class channel;
+    SendAwaiter(channel *ch, T &&value)
+        : channel_(ch), value_(std::move(value)) {}
+
+    channel *channel_;
+    T value_;
+    bool sent_ = false;
+    std::coroutine_handle<> handle_;
+    intrusive_list_hook hook_;
+  };
+
+  ReceiveAwaiter receive() { return ReceiveAwaiter(this); }
+  SendAwaiter send(T value) { return SendAwaiter(this, std::move(value)); }
+
+  // Non-suspending forms, for callers outside a coroutine. try_receive
+  // returns an empty optional if nothing is ready; try_send returns false
+  // if the value would have to wait.
+  std::optional<T> try_receive() {
+    std::optional<T> value;
+    take(value);
+    return value;
+  }
+  bool try_send(T value) {
+    bool sent = false;
+    put(value, sent);
+    return sent;
+  }
+
+  void close() {
+    if (closed_) return;
+    closed_ = true;
+    // Receivers only wait on an empty buffer; senders get their value back.
+    while (!receivers_.empty()) wake(receivers_);
+    while (!senders_.empty()) wake(senders_);
+  }
+
+  bool closed() const noexcept { return closed_; }
+  size_type capacity() const noexcept { return capacity_; }
+  // Buffered values, not counting senders still waiting.
+  size_type size() const noexcept { return buffer_.size(); }
+
+ private:
+  // Unlinks the first waiter of list and schedules it.
+  template <class List>
+  void wake(List &list) {
+    auto &waiter = list.front();
+    list.pop_front();
+    executor_.schedule(waiter.handle_);
+  }
+
+  // Takes the next value into value if there is one, or leaves value empty
+  // if the channel is closed and drained. Returns false if the receiver has
+  // to wait.
+  bool take(std::optional<T> &value) {
+    if (!buffer_.empty()) {
+      value.emplace(std::move(buffer_.front()));
+      buffer_.pop();
+      // The slot just freed goes to the longest-waiting sender.
+      if (!senders_.empty()) {
+        SendAwaiter &sender = senders_.front();
+        buffer_.push(std::move(sender.value_));
+        sender.sent_ = true;
+        wake(senders_);
+      }
+      return true;
+    }
+    if (!senders_.empty()) {
+      SendAwaiter &sender = senders_.front();
+      value.emplace(std::move(sender.value_));
+      sender.sent_ = true;
+      wake(senders_);
+      return true;
+    }
+    return closed_;
+  }
+
+  // Hands value to a waiting receiver or the buffer, or sets sent to false
+  // if the channel is closed. Returns false if the sender has to wait.
+  bool put(T &value, bool &sent) {
+    if (closed_) {
+      sent = false;
+      return true;
+    }
+    if (!receivers_.empty()) {
+      receivers_.front().value_.emplace(std::move(value));
+      wake(receivers_);
+      sent = true;
+      return true;
+    }
+    if (buffer_.size() < capacity_) {
+      buffer_.push(std::move(value));
+      sent = true;
+      return true;
+    }
+    return false;
+  }
+
+  executor &executor_;
+  size_type capacity_;
+  queue<T> buffer_;
+  intrusive_list<ReceiveAwaiter, &ReceiveAwaiter::hook_> receivers_;
+  intrusive_list<SendAwaiter, &SendAwaiter::hook_> senders_;
+  bool closed_ = false;
+};
+}  // namespace myn
+
+#endif  // __cpp_impl_coroutine
+
+#endif  // SRC_INCLUDE_CHANNEL_H_
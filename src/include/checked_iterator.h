@@ -0,0 +1,51 @@
+#ifndef SRC_INCLUDE_CHECKED_ITERATOR_H_
+#define SRC_INCLUDE_CHECKED_ITERATOR_H_
+
+// Checked iterators are opt-in: build with -DMYN_CHECKED_ITERATORS to make
+// every container iterator remember the generation of its container and
+// throw on stale or out-of-range use. Without the macro nothing in this file
+// is used and iterators stay a single pointer.
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace myn {
+#ifdef MYN_CHECKED_ITERATORS
+// State a contiguous container shares with its RandomAccessIterators: the
+// container's storage (read through pointers to its members, so the bounds
+// follow push_back) and a generation bumped on every invalidating change.
+template <class T>
+class iterator_guard {
+ public:
+  iterator_guard(T *const *data, const std::size_t *size) noexcept
+      : data_(data), size_(size) {}
+  iterator_guard(const iterator_guard &) = delete;
+  iterator_guard &operator=(const iterator_guard &) = delete;
+
+  void invalidate() noexcept { ++generation_; }
+  std::size_t generation() const noexcept { return generation_; }
+  const T *first() const noexcept { return *data_; }
+  const T *last() const noexcept { return *data_ + *size_; }
+
+ private:
+  T *const *data_;
+  const std::size_t *size_;
+  std::size_t generation_ = 0;
+};
+
+inline void check_iterator_generation(std::size_t container,
+                                      std::size_t iterator) {
+  if (container != iterator) {
+    throw std::logic_error("iterator is invalidated");
+  }
+}
+
+inline void check_iterator_range(bool in_range) {
+  if (!in_range) {
+    throw std::out_of_range("iterator is out of range");
+  }
+}
+#endif
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_CHECKED_ITERATOR_H_
@@ -0,0 +1,409 @@
+#ifndef SRC_INCLUDE_CONCURRENT_MAP_H_
+#define SRC_INCLUDE_CONCURRENT_MAP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "epoch.h"
+
+namespace myn {
+// Ordered map for many threads: a lock-free skip list (Herlihy and Shavit).
+// insert, find, contains and erase may run concurrently from any number of
+// threads; a node is first marked as deleted in all its levels and then
+// unlinked by whichever thread walks past it, and is freed through the
+// epoch_domain once no thread can still hold it.
+//
+// Values are immutable once inserted. Iterators pin the calling thread's
+// epoch, so the element they point to stays alive while they exist; they
+// are weakly consistent (they see every element present for the whole
+// traversal and may or may not see concurrent changes) and must not leave
+// the thread that created them.
+template <class Key, class T>
+class concurrent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+  using size_type = size_t;
+
+ private:
+  static constexpr int kMaxLevel = 24;
+
+  // The forward pointers follow the node in the same allocation, one per
+  // level. The low bit of a pointer marks the node that owns it as deleted.
+  // The alignment keeps them aligned whatever the key and value are: a
+  // misaligned atomic turns every CAS into a bus-locking split access.
+  struct alignas(std::atomic<std::uintptr_t>) Node {
+    template <typename... Args>
+    explicit Node(int height, Args &&...args)
+        : data_(std::forward<Args>(args)...), height_(height) {}
+    std::atomic<std::uintptr_t> *next() {
+      return reinterpret_cast<std::atomic<std::uintptr_t> *>(this + 1);
+    }
+    value_type data_;
+    int height_;
+  };
+
+ public:
+  class Iterator {
+   public:
+    using value_type = concurrent_map::value_type;
+    using reference = const value_type &;
+    using pointer = const value_type *;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    Iterator() = default;
+
+    reference operator*() const { return node_->data_; }
+    pointer operator->() const { return &node_->data_; }
+
+    Iterator &operator++() {
+      node_ = next_live(node_->next());
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return node_ == other.node_;
+    }
+    bool operator!=(const Iterator &other) const {
+      return node_ != other.node_;
+    }
+
+   private:
+    friend class concurrent_map;
+
+    Node *node_ = nullptr;
+    epoch_guard guard_;
+  };
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  concurrent_map() noexcept {
+    for (auto &next : head_) next.store(0, std::memory_order_relaxed);
+  }
+  concurrent_map(std::initializer_list<value_type> const &items)
+      : concurrent_map() {
+    for (const auto &item : items) insert(item);
+  }
+  concurrent_map(const concurrent_map &) = delete;
+  concurrent_map &operator=(const concurrent_map &) = delete;
+  // Not concurrent: no other thread may use the map any more.
+  ~concurrent_map() { clear(); }
+
+  // The element with the smallest key, or end(). begin() pins the thread
+  // before reading, so the returned node cannot be freed under the iterator.
+  iterator begin() const {
+    iterator it;
+    it.node_ = next_live(head_);
+    return it;
+  }
+  iterator end() const { return iterator(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  bool empty() const { return begin() == end(); }
+  // Exact when no other thread is changing the map.
+  size_type size() const noexcept {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  // Like map::insert: does nothing if the key is already present.
+  bool insert(const value_type &value) { return emplace(value); }
+  bool insert(const key_type &key, const mapped_type &obj) {
+    return emplace(key, obj);
+  }
+  template <typename... Args>
+  bool emplace(Args &&...args);
+  // Returns the number of elements removed (0 or 1).
+  size_type erase(const key_type &key);
+  // Not concurrent: no other thread may use the map during the call.
+  void clear() noexcept;
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const {
+    epoch_guard guard;
+    Node *node = lower_bound_node(key);
+    return node != nullptr && !(key < node->data_.first);
+  }
+  // First element whose key is not less than key: the start of an ordered
+  // range scan.
+  iterator lower_bound(const key_type &key) const {
+    iterator it;
+    it.node_ = lower_bound_node(key);
+    return it;
+  }
+
+ private:
+  using link_type = std::atomic<std::uintptr_t>;
+
+  static Node *pointer(std::uintptr_t link) {
+    return reinterpret_cast<Node *>(link & ~std::uintptr_t(1));
+  }
+  static bool marked(std::uintptr_t link) { return (link & 1) != 0; }
+  static std::uintptr_t to_link(Node *node, bool mark = false) {
+    return reinterpret_cast<std::uintptr_t>(node) | std::uintptr_t(mark);
+  }
+
+  // Forward pointers of a predecessor; nullptr stands for the head.
+  link_type *next_of(Node *pred) const {
+    return pred == nullptr ? const_cast<link_type *>(head_) : pred->next();
+  }
+
+  // First node after next[0] that is not marked as deleted.
+  static Node *next_live(const link_type *next) {
+    Node *node = pointer(next[0].load(std::memory_order_acquire));
+    while (node != nullptr &&
+           marked(node->next()[0].load(std::memory_order_acquire))) {
+      node = pointer(node->next()[0].load(std::memory_order_acquire));
+    }
+    return node;
+  }
+
+  // Fills preds/succs with the nodes around key on every level, unlinking
+  // the marked nodes it passes. Returns whether succs[0] holds key.
+  bool find_position(const key_type &key, Node **preds, Node **succs);
+  // Read-only search: never writes, skips marked nodes instead.
+  Node *lower_bound_node(const key_type &key) const;
+
+  static int random_height();
+  template <typename... Args>
+  static Node *create_node(int height, Args &&...args);
+  static void destroy_node(void *node);
+
+  link_type head_[kMaxLevel];
+  std::atomic<size_type> size_{0};
+};
+
+template <class Key, class T>
+template <typename... Args>
+bool concurrent_map<Key, T>::emplace(Args &&...args) {
+  Node *node = create_node(random_height(), std::forward<Args>(args)...);
+  const key_type &key = node->data_.first;
+  const int height = node->height_;
+  Node *preds[kMaxLevel];
+  Node *succs[kMaxLevel];
+  epoch_guard guard;
+  while (true) {
+    if (find_position(key, preds, succs)) {
+      destroy_node(node);
+      return false;
+    }
+    for (int level = 0; level < height; ++level) {
+      node->next()[level].store(to_link(succs[level]),
+                                std::memory_order_relaxed);
+    }
+    std::uintptr_t expected = to_link(succs[0]);
+    // Linking the bottom level is the linearization point of the insert.
+    if (next_of(preds[0])[0].compare_exchange_strong(
+            expected, to_link(node), std::memory_order_release,
+            std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+
+  for (int level = 1; level < height; ++level) {
+    while (true) {
+      std::uintptr_t next = node->next()[level].load(std::memory_order_acquire);
+      // Already being erased: stop building the tower.
+      if (marked(next)) goto linked;
+      if (pointer(next) != succs[level] &&
+          !node->next()[level].compare_exchange_strong(
+              next, to_link(succs[level]), std::memory_order_release,
+              std::memory_order_relaxed)) {
+        continue;
+      }
+      std::uintptr_t expected = to_link(succs[level]);
+      // seq_cst, paired with the mark in erase: see below.
+      if (next_of(preds[level])[level].compare_exchange_strong(
+              expected, to_link(node), std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        break;
+      }
+      find_position(key, preds, succs);
+      if (succs[0] != node) goto linked;
+    }
+  }
+linked:
+  // An erase that raced with the tower may have finished its own cleanup
+  // before the last level was linked; unlink the node again before the
+  // guard is released and it can be freed. Linking a level then reading
+  // the mark here, against marking then reading the links in erase, is a
+  // store-buffering pattern: with acquire/release both sides could miss
+  // the other's write and leave a retired node reachable. Making both
+  // writes seq_cst, with this load and the fence in erase, guarantees at
+  // least one side sees the other.
+  if (marked(node->next()[0].load(std::memory_order_seq_cst))) {
+    find_position(key, preds, succs);
+  }
+  return true;
+}
+
+template <class Key, class T>
+typename concurrent_map<Key, T>::size_type concurrent_map<Key, T>::erase(
+    const key_type &key) {
+  Node *preds[kMaxLevel];
+  Node *succs[kMaxLevel];
+  epoch_guard guard;
+  if (!find_position(key, preds, succs)) return 0;
+  Node *victim = succs[0];
+  for (int level = victim->height_ - 1; level > 0; --level) {
+    std::uintptr_t next = victim->next()[level].load(std::memory_order_acquire);
+    while (!marked(next) &&
+           !victim->next()[level].compare_exchange_weak(
+               next, next | 1, std::memory_order_acq_rel,
+               std::memory_order_acquire)) {
+    }
+  }
+  std::uintptr_t next = victim->next()[0].load(std::memory_order_acquire);
+  while (!marked(next)) {
+    // Marking the bottom level is the linearization point; only one thread
+    // wins it and becomes responsible for freeing the node.
+    if (victim->next()[0].compare_exchange_weak(next, next | 1,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_acquire)) {
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      // Orders the unlinking reads after the mark; see emplace.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      find_position(key, preds, succs);
+      epoch_domain::instance().retire(victim, &destroy_node);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <class Key, class T>
+void concurrent_map<Key, T>::clear() noexcept {
+  Node *node = pointer(head_[0].load(std::memory_order_relaxed));
+  while (node != nullptr) {
+    Node *next = pointer(node->next()[0].load(std::memory_order_relaxed));
+    // Marked nodes have already been retired by their eraser.
+    if (!marked(node->next()[0].load(std::memory_order_relaxed))) {
+      destroy_node(node);
+    }
+    node = next;
+  }
+  for (auto &next : head_) next.store(0, std::memory_order_relaxed);
+  size_.store(0, std::memory_order_relaxed);
+}
+
+template <class Key, class T>
+typename concurrent_map<Key, T>::iterator concurrent_map<Key, T>::find(
+    const key_type &key) const {
+  iterator it;
+  Node *node = lower_bound_node(key);
+  if (node != nullptr && !(key < node->data_.first)) it.node_ = node;
+  return it;
+}
+
+template <class Key, class T>
+bool concurrent_map<Key, T>::find_position(const key_type &key, Node **preds,
+                                           Node **succs) {
+retry:
+  Node *pred = nullptr;
+  Node *curr = nullptr;
+  for (int level = kMaxLevel - 1; level >= 0; --level) {
+    curr = pointer(next_of(pred)[level].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+      std::uintptr_t succ = curr->next()[level].load(std::memory_order_acquire);
+      while (marked(succ)) {
+        std::uintptr_t expected = to_link(curr);
+        if (!next_of(pred)[level].compare_exchange_strong(
+                expected, to_link(pointer(succ)), std::memory_order_release,
+                std::memory_order_relaxed)) {
+          goto retry;
+        }
+        curr = pointer(succ);
+        if (curr == nullptr) break;
+        succ = curr->next()[level].load(std::memory_order_acquire);
+      }
+      if (curr == nullptr || !(curr->data_.first < key)) break;
+      pred = curr;
+      curr = pointer(succ);
+    }
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+  return curr != nullptr && !(key < curr->data_.first);
+}
+
+template <class Key, class T>
+typename concurrent_map<Key, T>::Node *concurrent_map<Key, T>::lower_bound_node(
+    const key_type &key) const {
+  Node *pred = nullptr;
+  Node *curr = nullptr;
+  for (int level = kMaxLevel - 1; level >= 0; --level) {
+    curr = pointer(next_of(pred)[level].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+      std::uintptr_t succ = curr->next()[level].load(std::memory_order_acquire);
+      if (marked(succ)) {
+        curr = pointer(succ);
+      } else if (curr->data_.first < key) {
+        pred = curr;
+        curr = pointer(succ);
+      } else {
+        break;
+      }
+    }
+  }
+  return curr;
+}
+
+template <class Key, class T>
+int concurrent_map<Key, T>::random_height() {
+  // xorshift per thread; each level is kept with probability 1/2.
+  thread_local std::uint32_t state =
+      0x9e3779b9u ^
+      static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state));
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  int height = 1;
+  for (std::uint32_t bits = state; (bits & 1) && height < kMaxLevel;
+       bits >>= 1) {
+    ++height;
+  }
+  return height;
+}
+
+template <class Key, class T>
+template <typename... Args>
+typename concurrent_map<Key, T>::Node *concurrent_map<Key, T>::create_node(
+    int height, Args &&...args) {
+  void *memory = ::operator new(sizeof(Node) + height * sizeof(link_type));
+  Node *node;
+  try {
+    node = ::new (memory) Node(height, std::forward<Args>(args)...);
+  } catch (...) {
+    ::operator delete(memory);
+    throw;
+  }
+  for (int level = 0; level < height; ++level) {
+    ::new (static_cast<void *>(node->next() + level)) link_type(0);
+  }
+  return node;
+}
+
+template <class Key, class T>
+void concurrent_map<Key, T>::destroy_node(void *memory) {
+  Node *node = static_cast<Node *>(memory);
+  node->~Node();
+  ::operator delete(memory);
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_CONCURRENT_MAP_H_
@@ -0,0 +1,167 @@
+#ifndef SRC_INCLUDE_CONCURRENT_STACK_H_
+#define SRC_INCLUDE_CONCURRENT_STACK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "epoch.h"
+
+namespace myn {
+// Lock-free LIFO stack for many threads (Treiber). push and try_pop swing
+// the top pointer with one CAS. A popped node is retired through the
+// epoch_domain rather than deleted, so while a thread is between reading
+// top and its CAS the node cannot be freed and its address cannot come
+// back as a new node: that rules out ABA as well as use-after-free.
+//
+// With EliminationSlots > 0, a push and a pop whose CAS on top failed meet
+// in a small side array and cancel out without touching top at all, which
+// keeps throughput up when many threads hammer the stack.
+template <class T, std::size_t EliminationSlots = 0>
+class concurrent_stack {
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+  concurrent_stack() noexcept {}
+  concurrent_stack(const concurrent_stack &) = delete;
+  concurrent_stack &operator=(const concurrent_stack &) = delete;
+  // Not concurrent: no other thread may use the stack any more.
+  ~concurrent_stack() {
+    Node *node = top_.load(std::memory_order_relaxed);
+    while (node != nullptr) {
+      Node *next = node->next_;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Only a snapshot while other threads are pushing or popping.
+  bool empty() const noexcept {
+    return top_.load(std::memory_order_acquire) == nullptr;
+  }
+
+  void push(const_reference value) { push_node(new Node(value)); }
+  void push(value_type &&value) { push_node(new Node(std::move(value))); }
+  template <typename... Args>
+  void emplace(Args &&...args) {
+    push_node(new Node(std::forward<Args>(args)...));
+  }
+
+  // Moves the top element into value; returns false if the stack is empty.
+  bool try_pop(value_type &value);
+
+ private:
+  struct Node {
+    template <typename... Args>
+    explicit Node(Args &&...args) : value_(std::forward<Args>(args)...) {}
+    value_type value_;
+    Node *next_ = nullptr;
+  };
+
+  // One cache line per slot, so threads meeting in different slots do not
+  // invalidate each other.
+  struct alignas(64) Slot {
+    std::atomic<Node *> node_{nullptr};
+  };
+  static constexpr int kEliminationSpins = 64;
+
+  void push_node(Node *node);
+  bool try_push_top(Node *node) {
+    Node *top = top_.load(std::memory_order_relaxed);
+    node->next_ = top;
+    return top_.compare_exchange_weak(top, node, std::memory_order_release,
+                                      std::memory_order_relaxed);
+  }
+  bool eliminate_push(Node *node);
+  Node *eliminate_pop();
+  static Slot &random_slot(Slot *slots);
+  static void destroy_node(void *node) { delete static_cast<Node *>(node); }
+
+  std::atomic<Node *> top_{nullptr};
+  Slot slots_[EliminationSlots == 0 ? 1 : EliminationSlots];
+};
+
+template <class T, std::size_t EliminationSlots>
+void concurrent_stack<T, EliminationSlots>::push_node(Node *node) {
+  // The guard keeps a node handed to a popper through a slot alive until
+  // this thread has stopped comparing against its address.
+  epoch_guard guard;
+  while (!try_push_top(node)) {
+    if (EliminationSlots != 0 && eliminate_push(node)) return;
+  }
+}
+
+template <class T, std::size_t EliminationSlots>
+bool concurrent_stack<T, EliminationSlots>::try_pop(value_type &value) {
+  epoch_guard guard;
+  Node *node = nullptr;
+  while (true) {
+    Node *top = top_.load(std::memory_order_acquire);
+    if (top == nullptr) return false;
+    if (top_.compare_exchange_weak(top, top->next_, std::memory_order_acquire,
+                                   std::memory_order_relaxed)) {
+      node = top;
+      break;
+    }
+    if (EliminationSlots != 0 && (node = eliminate_pop()) != nullptr) break;
+  }
+  value = std::move(node->value_);
+  epoch_domain::instance().retire(node, &destroy_node);
+  return true;
+}
+
+// Offers node in a random slot for a while. Returns true if a popper took
+// it, false if the offer was withdrawn.
+template <class T, std::size_t EliminationSlots>
+bool concurrent_stack<T, EliminationSlots>::eliminate_push(Node *node) {
+  Slot &slot = random_slot(slots_);
+  Node *expected = nullptr;
+  if (!slot.node_.compare_exchange_strong(expected, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    return false;
+  }
+  for (int spin = 0; spin < kEliminationSpins; ++spin) {
+    if (slot.node_.load(std::memory_order_relaxed) != node) return true;
+  }
+  expected = node;
+  return !slot.node_.compare_exchange_strong(expected, nullptr,
+                                             std::memory_order_relaxed,
+                                             std::memory_order_relaxed);
+}
+
+// Takes a node a pusher is offering in a random slot, if there is one.
+template <class T, std::size_t EliminationSlots>
+typename concurrent_stack<T, EliminationSlots>::Node *
+concurrent_stack<T, EliminationSlots>::eliminate_pop() {
+  Slot &slot = random_slot(slots_);
+  for (int spin = 0; spin < kEliminationSpins; ++spin) {
+    Node *node = slot.node_.load(std::memory_order_acquire);
+    if (node != nullptr &&
+        slot.node_.compare_exchange_strong(node, nullptr,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+template <class T, std::size_t EliminationSlots>
+typename concurrent_stack<T, EliminationSlots>::Slot &
+concurrent_stack<T, EliminationSlots>::random_slot(Slot *slots) {
+  thread_local std::uint32_t state =
+      0x9e3779b9u ^
+      static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state));
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return slots[EliminationSlots == 0 ? 0 : state % EliminationSlots];
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_CONCURRENT_STACK_H_
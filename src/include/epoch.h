@@ -0,0 +1,181 @@
+#ifndef SRC_INCLUDE_EPOCH_H_
+#define SRC_INCLUDE_EPOCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace myn {
+// Epoch-based memory reclamation for the lock-free containers.
+//
+// A thread pins the current global epoch (through epoch_guard) for as long
+// as it holds raw pointers into a shared structure. A node unlinked from the
+// structure is retire()d instead of deleted, tagged with the epoch at that
+// moment. The global epoch only moves forward once every pinned thread has
+// seen the current value, so after it has advanced twice past the tag no
+// thread can still reach the node and it is freed.
+class epoch_domain {
+ public:
+  using deleter_type = void (*)(void *);
+
+  static epoch_domain &instance() {
+    static epoch_domain domain;
+    return domain;
+  }
+
+  epoch_domain(const epoch_domain &) = delete;
+  epoch_domain &operator=(const epoch_domain &) = delete;
+  ~epoch_domain() {
+    for (const Retired &retired : orphans_) retired.deleter_(retired.ptr_);
+    for (Record *record = records_.load(); record != nullptr;) {
+      Record *next = record->next_;
+      delete record;
+      record = next;
+    }
+  }
+
+  void pin() {
+    ThreadState &state = thread_state();
+    if (state.nesting_++ == 0) {
+      std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+      state.record_->state_.store((epoch << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  void unpin() {
+    ThreadState &state = thread_state();
+    if (--state.nesting_ == 0) {
+      state.record_->state_.store(0, std::memory_order_release);
+    }
+  }
+
+  // Hands ptr over for deletion once no pinned thread can still see it.
+  void retire(void *ptr, deleter_type deleter) {
+    ThreadState &state = thread_state();
+    state.limbo_.push_back({ptr, deleter, epoch_.load()});
+    if (state.limbo_.size() >= kCollectThreshold) collect(state);
+  }
+
+  // Frees the calling thread's retired objects that are no longer reachable.
+  void collect() { collect(thread_state()); }
+
+ private:
+  static constexpr std::size_t kCollectThreshold = 64;
+
+  // Per-thread announcement: (epoch << 1) | 1 while pinned, 0 otherwise.
+  struct Record {
+    std::atomic<std::uint64_t> state_{0};
+    std::atomic<bool> in_use_{false};
+    Record *next_ = nullptr;
+  };
+  struct Retired {
+    void *ptr_;
+    deleter_type deleter_;
+    std::uint64_t epoch_;
+  };
+  struct ThreadState {
+    ThreadState()
+        : domain_(instance()), record_(domain_.acquire_record()) {}
+    ~ThreadState() { domain_.release(*this); }
+    epoch_domain &domain_;
+    Record *record_;
+    unsigned nesting_ = 0;
+    std::vector<Retired> limbo_;
+  };
+
+  epoch_domain() = default;
+
+  static ThreadState &thread_state() {
+    thread_local ThreadState state;
+    return state;
+  }
+
+  Record *acquire_record() {
+    for (Record *record = records_.load(); record != nullptr;
+         record = record->next_) {
+      bool expected = false;
+      if (!record->in_use_.load() &&
+          record->in_use_.compare_exchange_strong(expected, true)) {
+        return record;
+      }
+    }
+    Record *record = new Record;
+    record->in_use_.store(true);
+    Record *head = records_.load();
+    do {
+      record->next_ = head;
+    } while (!records_.compare_exchange_weak(head, record));
+    return record;
+  }
+
+  // Called when a thread exits: whatever it could not free yet is left to
+  // the threads that keep running (or to the domain's destructor).
+  void release(ThreadState &state) {
+    collect(state);
+    if (!state.limbo_.empty()) {
+      std::lock_guard<std::mutex> lock(orphans_mutex_);
+      orphans_.insert(orphans_.end(), state.limbo_.begin(),
+                      state.limbo_.end());
+      has_orphans_.store(true);
+    }
+    state.record_->state_.store(0);
+    state.record_->in_use_.store(false);
+  }
+
+  bool try_advance() {
+    std::uint64_t epoch = epoch_.load();
+    for (Record *record = records_.load(); record != nullptr;
+         record = record->next_) {
+      std::uint64_t state = record->state_.load();
+      if ((state & 1) && (state >> 1) != epoch) return false;
+    }
+    return epoch_.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  static void free_expired(std::vector<Retired> &retired,
+                           std::uint64_t epoch) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired.size(); ++i) {
+      if (retired[i].epoch_ + 2 <= epoch) {
+        retired[i].deleter_(retired[i].ptr_);
+      } else {
+        retired[kept++] = retired[i];
+      }
+    }
+    retired.resize(kept);
+  }
+
+  void collect(ThreadState &state) {
+    try_advance();
+    std::uint64_t epoch = epoch_.load();
+    free_expired(state.limbo_, epoch);
+    if (has_orphans_.load(std::memory_order_relaxed)) {
+      std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+      if (lock.owns_lock()) {
+        free_expired(orphans_, epoch);
+        has_orphans_.store(!orphans_.empty());
+      }
+    }
+  }
+
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<Record *> records_{nullptr};
+  std::mutex orphans_mutex_;
+  std::vector<Retired> orphans_;
+  std::atomic<bool> has_orphans_{false};
+};
+
+// Keeps the calling thread pinned for its lifetime. Guards nest, and a copy
+// pins again, but a guard must be destroyed on the thread that created it.
+class epoch_guard {
+ public:
+  epoch_guard() { epoch_domain::instance().pin(); }
+  epoch_guard(const epoch_guard &) : epoch_guard() {}
+  epoch_guard &operator=(const epoch_guard &) { return *this; }
+  ~epoch_guard() { epoch_domain::instance().unpin(); }
+};
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_EPOCH_H_
@@ -0,0 +1,223 @@
+#ifndef SRC_INCLUDE_INDEXED_PRIORITY_QUEUE_H_
+#define SRC_INCLUDE_INDEXED_PRIORITY_QUEUE_H_
+
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.h"
+
+namespace myn {
+// Heap of (id, key) entries where the ids are small dense integers, each
+// present at most once, and the key of an id already in the heap can be
+// changed or the id removed in O(log n). This is the queue of Dijkstra's and
+// Prim's algorithms: relaxing an edge is one decrease_key instead of an
+// erase and a reinsert.
+//
+// Unlike priority_queue the top is the smallest key under Compare, as the
+// decrease-key name implies.
+//
+// Two flat vectors: the heap itself, holding (key, id) so that sifting
+// compares keys without indirection, and position_, mapping every id to its
+// slot in the heap (kAbsent if it is not queued). position_ grows to the
+// largest id pushed so far.
+template <typename Key, class Compare = std::less<Key>, size_t Arity = 2>
+class indexed_priority_queue {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+ public:
+  using key_type = Key;
+  using key_compare = Compare;
+  using size_type = size_t;
+  using id_type = size_t;
+
+  indexed_priority_queue() {}
+  // Makes room for ids 0 to ids - 1 without further allocation.
+  explicit indexed_priority_queue(size_type ids,
+                                  const Compare &comp = Compare())
+      : comp_(comp) {
+    reserve(ids);
+  }
+
+  void reserve(size_type ids) {
+    heap_.reserve(ids);
+    grow_positions(ids);
+  }
+
+  bool empty() const noexcept { return heap_.size() == 0; }
+  size_type size() const noexcept { return heap_.size(); }
+  bool contains(id_type id) const noexcept {
+    return id < position_.size() && position_[id] != kAbsent;
+  }
+  // Throws std::out_of_range if id is not queued.
+  const key_type &key(id_type id) const {
+    return heap_[checked_position(id)].key_;
+  }
+
+  id_type top_id() const {
+    check_not_empty();
+    return heap_[0].id_;
+  }
+  const key_type &top_key() const {
+    check_not_empty();
+    return heap_[0].key_;
+  }
+
+  // Throws std::invalid_argument if id is already queued.
+  void push(id_type id, const key_type &key) { emplace(id, key); }
+  void push(id_type id, key_type &&key) { emplace(id, std::move(key)); }
+  template <typename... Args>
+  void emplace(id_type id, Args &&...args);
+
+  void pop() {
+    check_not_empty();
+    remove_at(0);
+  }
+  // Returns how many ids were removed: 0 or 1.
+  size_type erase(id_type id) {
+    if (!contains(id)) return 0;
+    remove_at(position_[id]);
+    return 1;
+  }
+  void clear() noexcept {
+    for (size_type i = 0; i < heap_.size(); ++i) {
+      position_[heap_[i].id_] = kAbsent;
+    }
+    heap_.clear();
+  }
+
+  // Both throw std::out_of_range if id is not queued, and
+  // std::invalid_argument if key moves the other way.
+  void decrease_key(id_type id, const key_type &key) {
+    size_type i = checked_position(id);
+    if (comp_(heap_[i].key_, key)) {
+      throw std::invalid_argument("key is larger (decrease_key)");
+    }
+    heap_[i].key_ = key;
+    sift_up(i);
+  }
+  void increase_key(id_type id, const key_type &key) {
+    size_type i = checked_position(id);
+    if (comp_(key, heap_[i].key_)) {
+      throw std::invalid_argument("key is smaller (increase_key)");
+    }
+    heap_[i].key_ = key;
+    sift_down(i);
+  }
+  // Sets the key of id whichever way it moves.
+  void update_key(id_type id, const key_type &key) {
+    size_type i = checked_position(id);
+    heap_[i].key_ = key;
+    restore(i);
+  }
+
+ private:
+  static constexpr size_type kAbsent = std::numeric_limits<size_type>::max();
+
+  struct Entry {
+    key_type key_;
+    id_type id_;
+  };
+
+  static size_type parent(size_type i) { return (i - 1) / Arity; }
+  static size_type first_child(size_type i) { return i * Arity + 1; }
+
+  void grow_positions(size_type ids) {
+    if (ids <= position_.size()) return;
+    position_.reserve(ids);
+    while (position_.size() < ids) position_.push_back(kAbsent);
+  }
+
+  size_type checked_position(id_type id) const {
+    if (!contains(id)) {
+      throw std::out_of_range("id is not in the queue");
+    }
+    return position_[id];
+  }
+
+  // Moves entry into slot i and records where its id now is.
+  void place(size_type i, Entry &&entry) {
+    position_[entry.id_] = i;
+    heap_[i] = std::move(entry);
+  }
+
+  // As in priority_queue, the moving entry waits in a local while the others
+  // shift over the hole.
+  void sift_up(size_type i) {
+    Entry entry = std::move(heap_[i]);
+    while (i > 0 && comp_(entry.key_, heap_[parent(i)].key_)) {
+      place(i, std::move(heap_[parent(i)]));
+      i = parent(i);
+    }
+    place(i, std::move(entry));
+  }
+
+  void sift_down(size_type i) {
+    const size_type n = heap_.size();
+    Entry entry = std::move(heap_[i]);
+    while (true) {
+      size_type child = first_child(i);
+      if (child >= n) break;
+      size_type last = child + Arity < n ? child + Arity : n;
+      size_type best = child;
+      for (++child; child < last; ++child) {
+        if (comp_(heap_[child].key_, heap_[best].key_)) best = child;
+      }
+      if (!comp_(heap_[best].key_, entry.key_)) break;
+      place(i, std::move(heap_[best]));
+      i = best;
+    }
+    place(i, std::move(entry));
+  }
+
+  void restore(size_type i) {
+    if (i > 0 && comp_(heap_[i].key_, heap_[parent(i)].key_)) {
+      sift_up(i);
+    } else {
+      sift_down(i);
+    }
+  }
+
+  // Fills slot i with the last entry, which may have to go either way when
+  // i is not the root.
+  void remove_at(size_type i) {
+    position_[heap_[i].id_] = kAbsent;
+    size_type last = heap_.size() - 1;
+    if (i != last) {
+      heap_[i] = std::move(heap_[last]);
+      heap_.pop_back();
+      restore(i);
+    } else {
+      heap_.pop_back();
+    }
+  }
+
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("indexed_priority_queue is empty");
+    }
+  }
+
+  vector<Entry> heap_;
+  vector<size_type> position_;
+  Compare comp_;
+};
+
+template <typename Key, class Compare, size_t Arity>
+template <typename... Args>
+void indexed_priority_queue<Key, Compare, Arity>::emplace(id_type id,
+                                                          Args &&...args) {
+  if (contains(id)) {
+    throw std::invalid_argument("id is already in the queue");
+  }
+  if (id >= position_.size()) {
+    grow_positions(id + 1 > 2 * position_.size() ? id + 1
+                                                 : 2 * position_.size());
+  }
+  heap_.push_back(Entry{key_type(std::forward<Args>(args)...), id});
+  sift_up(heap_.size() - 1);
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_INDEXED_PRIORITY_QUEUE_H_
@@ -0,0 +1,309 @@
+#ifndef SRC_INCLUDE_INTRUSIVE_LIST_H_
+#define SRC_INCLUDE_INTRUSIVE_LIST_H_
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+
+namespace myn {
+// Links embedded in an element of an intrusive_list. An element can sit in
+// as many intrusive lists at once as it has hooks. Copying the element does
+// not copy its links. In checked builds (MYN_CHECKED_ITERATORS) a hook also
+// remembers its list, and linking a hook twice, unlinking it from the wrong
+// list or destroying it while linked is trapped.
+class intrusive_list_hook {
+ public:
+  intrusive_list_hook() noexcept {}
+  intrusive_list_hook(const intrusive_list_hook &) noexcept {}
+  intrusive_list_hook &operator=(const intrusive_list_hook &) noexcept {
+    return *this;
+  }
+  ~intrusive_list_hook() {
+#ifdef MYN_CHECKED_ITERATORS
+    if (is_linked()) std::terminate();
+#endif
+  }
+
+  bool is_linked() const noexcept { return next_ != nullptr; }
+
+ private:
+  template <class T, intrusive_list_hook T::*Hook>
+  friend class intrusive_list;
+
+  intrusive_list_hook *prev_ = nullptr;
+  intrusive_list_hook *next_ = nullptr;
+#ifdef MYN_CHECKED_ITERATORS
+  const void *owner_ = nullptr;
+#endif
+};
+
+// Doubly-linked list over objects the caller owns: the links live in the
+// object's Hook member, so insert, erase and splice never allocate or copy.
+// The list does not own its elements; an element must be erased (or the
+// list cleared) before it is destroyed.
+template <class T, intrusive_list_hook T::*Hook>
+class intrusive_list {
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+ private:
+  using hook_type = intrusive_list_hook;
+
+ public:
+  template <typename Value>
+  class IntrusiveIterator {
+   public:
+    using value_type = T;
+    using reference = Value &;
+    using pointer = Value *;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    IntrusiveIterator() = default;
+    explicit IntrusiveIterator(hook_type *hook) : current_(hook) {}
+    // iterator converts to const_iterator
+    IntrusiveIterator(const IntrusiveIterator<T> &other)
+        : current_(other.current_) {}
+    IntrusiveIterator &operator=(const IntrusiveIterator &other) = default;
+
+    reference operator*() const { return *owner(current_); }
+    pointer operator->() const { return owner(current_); }
+
+    IntrusiveIterator &operator++() {
+      current_ = current_->next_;
+      return *this;
+    }
+    IntrusiveIterator operator++(int) {
+      IntrusiveIterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+    IntrusiveIterator &operator--() {
+      current_ = current_->prev_;
+      return *this;
+    }
+    IntrusiveIterator operator--(int) {
+      IntrusiveIterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const IntrusiveIterator &other) const {
+      return current_ == other.current_;
+    }
+    bool operator!=(const IntrusiveIterator &other) const {
+      return current_ != other.current_;
+    }
+
+   private:
+    friend class intrusive_list;
+    template <typename>
+    friend class IntrusiveIterator;
+    hook_type *current_ = nullptr;
+  };
+  using iterator = IntrusiveIterator<T>;
+  using const_iterator = IntrusiveIterator<const T>;
+
+  intrusive_list() noexcept { reset(); }
+  intrusive_list(const intrusive_list &) = delete;
+  intrusive_list(intrusive_list &&other) noexcept {
+    reset();
+    swap(other);
+  }
+  ~intrusive_list() {
+    clear();
+    // The sentinel is a hook too; leave it unlinked for its destructor.
+    head_.prev_ = nullptr;
+    head_.next_ = nullptr;
+  }
+
+  intrusive_list &operator=(const intrusive_list &) = delete;
+  intrusive_list &operator=(intrusive_list &&other) noexcept {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  iterator begin() noexcept { return iterator(head_.next_); }
+  iterator end() noexcept { return iterator(&head_); }
+  const_iterator cbegin() const noexcept {
+    return const_iterator(head_.next_);
+  }
+  const_iterator cend() const noexcept { return const_iterator(sentinel()); }
+
+  reference front() {
+    check_not_empty();
+    return *owner(head_.next_);
+  }
+  reference back() {
+    check_not_empty();
+    return *owner(head_.prev_);
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+
+  void push_back(reference value) { insert(end(), value); }
+  void push_front(reference value) { insert(begin(), value); }
+  void pop_back() {
+    check_not_empty();
+    unlink(head_.prev_);
+  }
+  void pop_front() {
+    check_not_empty();
+    unlink(head_.next_);
+  }
+
+  iterator insert(iterator pos, reference value);
+  iterator erase(iterator pos);
+  void erase(reference value) { unlink(&(value.*Hook)); }
+  // Unlinks every element; the elements themselves are left untouched.
+  void clear() noexcept;
+  void splice(iterator pos, intrusive_list &other);
+  void splice(iterator pos, intrusive_list &other, reference value);
+  void swap(intrusive_list &other) noexcept;
+
+  // O(1): the position of an element is its own hook.
+  iterator iterator_to(reference value) noexcept {
+    return iterator(&(value.*Hook));
+  }
+
+ private:
+  hook_type head_;
+  size_type size_ = 0;
+
+  // Address of the element that embeds hook, from the offset of Hook in T.
+  static T *owner(hook_type *hook) noexcept {
+    const T *probe = reinterpret_cast<const T *>(alignof(T) * 64);
+    const ptrdiff_t offset =
+        reinterpret_cast<const char *>(&(probe->*Hook)) -
+        reinterpret_cast<const char *>(probe);
+    return reinterpret_cast<T *>(reinterpret_cast<char *>(hook) - offset);
+  }
+  hook_type *sentinel() const noexcept {
+    return const_cast<hook_type *>(&head_);
+  }
+
+  void reset() noexcept {
+    head_.prev_ = &head_;
+    head_.next_ = &head_;
+  }
+  void link(hook_type *pos, hook_type *hook);
+  void unlink(hook_type *hook);
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("intrusive_list is empty");
+    }
+  }
+};
+
+template <class T, intrusive_list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::insert(
+    iterator pos, reference value) {
+  hook_type *hook = &(value.*Hook);
+  link(pos.current_, hook);
+  return iterator(hook);
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::erase(
+    iterator pos) {
+  hook_type *next = pos.current_->next_;
+  unlink(pos.current_);
+  return iterator(next);
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::clear() noexcept {
+  hook_type *hook = head_.next_;
+  while (hook != &head_) {
+    hook_type *next = hook->next_;
+    hook->prev_ = nullptr;
+    hook->next_ = nullptr;
+#ifdef MYN_CHECKED_ITERATORS
+    hook->owner_ = nullptr;
+#endif
+    hook = next;
+  }
+  reset();
+  size_ = 0;
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::splice(iterator pos, intrusive_list &other) {
+  if (this == &other || other.empty()) return;
+  hook_type *first = other.head_.next_;
+  hook_type *last = other.head_.prev_;
+#ifdef MYN_CHECKED_ITERATORS
+  for (hook_type *hook = first; hook != &other.head_; hook = hook->next_) {
+    hook->owner_ = this;
+  }
+#endif
+  hook_type *next = pos.current_;
+  hook_type *prev = next->prev_;
+  prev->next_ = first;
+  first->prev_ = prev;
+  last->next_ = next;
+  next->prev_ = last;
+  size_ += other.size_;
+  other.reset();
+  other.size_ = 0;
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::splice(iterator pos, intrusive_list &other,
+                                     reference value) {
+  hook_type *hook = &(value.*Hook);
+  if (hook == pos.current_ || hook->next_ == pos.current_) return;
+  other.unlink(hook);
+  link(pos.current_, hook);
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::swap(intrusive_list &other) noexcept {
+  if (this == &other) return;
+  intrusive_list temp;
+  temp.splice(temp.end(), *this);
+  splice(end(), other);
+  other.splice(other.end(), temp);
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::link(hook_type *pos, hook_type *hook) {
+#ifdef MYN_CHECKED_ITERATORS
+  if (hook->is_linked()) {
+    throw std::logic_error("element is already linked");
+  }
+  hook->owner_ = this;
+#endif
+  hook_type *prev = pos->prev_;
+  hook->prev_ = prev;
+  hook->next_ = pos;
+  prev->next_ = hook;
+  pos->prev_ = hook;
+  ++size_;
+}
+
+template <class T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::unlink(hook_type *hook) {
+#ifdef MYN_CHECKED_ITERATORS
+  if (hook->owner_ != this) {
+    throw std::logic_error("element is not linked into this list");
+  }
+  hook->owner_ = nullptr;
+#endif
+  hook->prev_->next_ = hook->next_;
+  hook->next_->prev_ = hook->prev_;
+  hook->prev_ = nullptr;
+  hook->next_ = nullptr;
+  --size_;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_INTRUSIVE_LIST_H_
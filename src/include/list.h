@@ -1,6 +1,11 @@
 #ifndef SRC_INCLUDE_LIST_H_
 #define SRC_INCLUDE_LIST_H_
 
+#include <memory>
+
+#include "checked_iterator.h"
+#include "node_pool.h"
+
 namespace myn {
 template <typename T>
 class list {
@@ -13,39 +18,63 @@ class list {
  private:
   struct node {
     node() : prev_(nullptr), next_(nullptr){};
-    node(const value_type &data, node *prev, node *next)
-        : data_(data), prev_(prev), next_(next){};
-    node(node *prev, node *next) : prev_(prev), next_(next){};
+    template <typename... Args>
+    node(node *prev, node *next, Args &&...args)
+        : data_(std::forward<Args>(args)...), prev_(prev), next_(next){};
     value_type data_;
     node *prev_ = nullptr;
     node *next_ = nullptr;
   };
+
+ public:
+  // Slab allocator the nodes come from. Each list creates its own on first
+  // insertion; pass one pool to several lists to share slabs between them.
+  // Lists that splice or merge nodes into each other end up sharing a pool:
+  // the other list's pool is folded into this one's, and every list still
+  // holding it follows on to the merged pool.
+  using pool_type = node_pool<node>;
+
+ private:
   size_t size_ = 0;
-  node *node_ = nullptr;
   node *begin_ = &end_;
   node end_;
+  std::shared_ptr<pool_type> pool_;
+#ifdef MYN_CHECKED_ITERATORS
+  size_t generation_ = 0;
+#endif
 
   void allocate(size_type n);
+  pool_type &pool();
+  template <typename... Args>
+  node *create_node(Args &&...args);
+  void destroy_node(node *n) noexcept;
 
  public:
   template <typename value_type>
   class ListIterator {
    public:
     ListIterator(node *node) : current_(node){};
+#ifdef MYN_CHECKED_ITERATORS
+    ListIterator(node *node, const list *owner)
+        : current_(node), list_(owner), generation_(owner->generation_){};
+#endif
 
     ListIterator operator++() {
-      node *temp = current_->next_;
+      check_valid(false);
       current_ = current_->next_;
-      return temp;
+      return *this;
     }
 
     ListIterator operator--() {
-      node *temp = current_->prev_;
+      check_valid(true);
       current_ = current_->prev_;
-      return temp;
+      return *this;
     }
 
-    reference operator*() { return current_->data_; }
+    reference operator*() {
+      check_valid(false);
+      return current_->data_;
+    }
 
     bool operator==(const ListIterator &other) const {
       return current_ == other.current_;
@@ -59,25 +88,48 @@ class list {
 
    private:
     node *current_;
+#ifdef MYN_CHECKED_ITERATORS
+    const list *list_ = nullptr;
+    size_t generation_ = 0;
+#endif
+
+    // Traps on iterators that outlived an erase of their list, on stepping
+    // back from begin() and on dereferencing or stepping past end(). Empty
+    // unless MYN_CHECKED_ITERATORS is set.
+    void check_valid([[maybe_unused]] bool backward) const {
+#ifdef MYN_CHECKED_ITERATORS
+      if (list_ == nullptr) return;
+      check_iterator_generation(list_->generation_, generation_);
+      check_iterator_range(current_ !=
+                           (backward ? list_->begin_ : &list_->end_));
+#endif
+    }
   };
   template <typename value_type>
   class ListConstIterator {
    public:
     ListConstIterator(const node *node) : current_(node){};
+#ifdef MYN_CHECKED_ITERATORS
+    ListConstIterator(const node *node, const list *owner)
+        : current_(node), list_(owner), generation_(owner->generation_){};
+#endif
 
     ListConstIterator operator++() {
-      node *temp = current_->next_;
+      check_valid(false);
       current_ = current_->next_;
-      return temp;
+      return *this;
     }
 
     ListConstIterator operator--() {
-      node *temp = current_->prev_;
+      check_valid(true);
       current_ = current_->prev_;
-      return temp;
+      return *this;
     }
 
-    const_reference operator*() const { return current_->data_; }
+    const_reference operator*() const {
+      check_valid(false);
+      return current_->data_;
+    }
 
     bool operator==(const ListConstIterator &other) const {
       return current_ == other.current_;
@@ -91,13 +143,27 @@ class list {
 
    private:
     const node *current_;
+#ifdef MYN_CHECKED_ITERATORS
+    const list *list_ = nullptr;
+    size_t generation_ = 0;
+#endif
+
+    void check_valid([[maybe_unused]] bool backward) const {
+#ifdef MYN_CHECKED_ITERATORS
+      if (list_ == nullptr) return;
+      check_iterator_generation(list_->generation_, generation_);
+      check_iterator_range(current_ !=
+                           (backward ? list_->begin_ : &list_->end_));
+#endif
+    }
   };
   using iterator = ListIterator<value_type>;
   using const_iterator = ListConstIterator<value_type>;
 
   // construct
-  list() : list{list(0)} {};
+  list() {}
   list(size_type n) { allocate(n); }
+  explicit list(std::shared_ptr<pool_type> pool) : pool_(std::move(pool)) {}
   list(std::initializer_list<value_type> const &items) {
     for (const auto &i : items) push_back(i);
   }
@@ -108,84 +174,77 @@ class list {
       current = current->next_;
     }
   }
-  list(list &&l) {
-    push_back(value_type());
-    swap(l);
-  }
-  ~list() {
-    node *next;
-    node *temp = begin_;
-    for (size_type i = 0; i < size_; temp = next, ++i) {
-      next = temp->next_;
-      delete temp;
-    }
-  }
+  // The source is left empty.
+  list(list &&l) { swap(l); }
+  ~list() { clear(); }
   void operator=(list &&l) {
     if (this != &l) {
-      push_back(value_type());
+      clear();
       swap(l);
     }
   }
 
   // // List Iterators
-  iterator begin() { return iterator(begin_); }
-  iterator end() { return iterator(&end_); }
-  const_iterator cbegin() const { return const_iterator(begin_); }
-  const_iterator cend() const { return const_iterator(&end_); }
+  iterator begin() { return make_iterator(begin_); }
+  iterator end() { return make_iterator(&end_); }
+  const_iterator cbegin() const { return make_const_iterator(begin_); }
+  const_iterator cend() const { return make_const_iterator(&end_); }
 
   // // List Element access
   const_reference front() { return begin_->data_; }
-  const_reference back() {
+  reference back() {
     if (end_.prev_ != nullptr)
       return (end_.prev_)->data_;
     else
       return begin_->data_;
   }
+  const_reference back() const { return const_cast<list *>(this)->back(); }
 
   // // List Capacity
-  bool empty() { return begin() == end(); }
-  size_type size() { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
   size_type max_size() { return SIZE_MAX / sizeof(*this); }
 
   // // List Modifiers
   void clear();
   iterator insert(iterator pos, const_reference value);
+  iterator insert(iterator pos, value_type &&value);
   iterator erase(iterator pos);
   iterator erase(iterator first, iterator last);
   void push_back(const_reference value);
+  void push_back(value_type &&value);
   void pop_back();
   void push_front(const_reference value);
+  void push_front(value_type &&value);
   void pop_front();
   void swap(list &other);
   void merge(list &other);
   void splice(const_iterator pos, list &other);
+  void splice(const_iterator pos, list &other, const_iterator it);
+  void splice(const_iterator pos, list &other, const_iterator first,
+              const_iterator last);
   void reverse();
   void unique();
   void sort();
 
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args &&...args);
+  template <typename... Args>
+  reference emplace_back(Args &&...args);
+  template <typename... Args>
+  reference emplace_front(Args &&...args);
+
+  // Constructs the new elements in place before pos, in argument order, and
+  // returns an iterator to the first of them (pos if there are none).
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args &&...args) {
-    list<T> newList;
-    for (auto it = cbegin(); it != pos; ++it) {
-      newList.push_back(*it);
-    }
-    for (auto &&arg : {std::forward<Args>(args)...}) {
-      newList.push_back(arg);
-    }
-    if (pos != cend()) {
-      for (auto it = pos; it != cend(); ++it) {
-        newList.push_back(*it);
-      }
-    }
-    clear();
-    for (auto &item : newList) {
-      push_back(item);
-    }
-    auto it = end();
-    for (size_t i = 0; i < sizeof...(Args); ++i) {
-      --it;
+    if constexpr (sizeof...(Args) == 0) {
+      return make_iterator(const_cast<node *>(&pos));
+    } else {
+      // A braced list is evaluated left to right.
+      iterator inserted[] = {emplace(pos, std::forward<Args>(args))...};
+      return inserted[0];
     }
-    return it;
   }
 
   template <typename... Args>
@@ -199,7 +258,33 @@ class list {
   }
 
  private:
-  iterator change_elements(iterator a, iterator b);
+  static node *merge_chains(node *first, node *second);
+  void adopt_nodes() noexcept;
+  void link_nodes(node *pos, node *first, node *last);
+  void unlink_nodes(node *first, node *last);
+  void splice_nodes(node *pos, list &other, node *first, node *last,
+                    size_type count);
+  void share_pool(list &other);
+
+  iterator make_iterator(node *n) {
+#ifdef MYN_CHECKED_ITERATORS
+    return iterator(n, this);
+#else
+    return iterator(n);
+#endif
+  }
+  const_iterator make_const_iterator(const node *n) const {
+#ifdef MYN_CHECKED_ITERATORS
+    return const_iterator(n, this);
+#else
+    return const_iterator(n);
+#endif
+  }
+  void invalidate_iterators() noexcept {
+#ifdef MYN_CHECKED_ITERATORS
+    ++generation_;
+#endif
+  }
 };
 
 template <typename T>
@@ -208,32 +293,95 @@ void list<T>::allocate(size_type n) {
 }
 
 template <typename T>
-void list<T>::push_back(const_reference value) {
-  if (end_.prev_ != nullptr) {
-    node *old_last = end_.prev_;
-    old_last->next_ = new struct node(value, old_last, &end_);
-    end_.prev_ = old_last->next_;
-  } else {
-    begin_ = node_ = new struct node(value, &end_, &end_);
-    end_.next_ = begin_;
-    end_.prev_ = begin_;
+typename list<T>::pool_type &list<T>::pool() {
+  if (pool_ == nullptr) pool_ = std::make_shared<pool_type>();
+  pool_type::follow(pool_);
+  return *pool_;
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::node *list<T>::create_node(Args &&...args) {
+  node *n = pool().allocate();
+  try {
+    new (n) node(std::forward<Args>(args)...);
+  } catch (...) {
+    pool_->deallocate(n);
+    throw;
   }
+  return n;
+}
+
+template <typename T>
+void list<T>::destroy_node(node *n) noexcept {
+  n->~node();
+  pool_type::follow(pool_);
+  pool_->deallocate(n);
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::iterator list<T>::emplace(const_iterator pos,
+                                            Args &&...args) {
+  node *new_node = create_node(nullptr, nullptr, std::forward<Args>(args)...);
+  link_nodes(const_cast<node *>(&pos), new_node, new_node);
   ++size_;
+  return make_iterator(new_node);
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::reference list<T>::emplace_back(Args &&...args) {
+  return *emplace(cend(), std::forward<Args>(args)...);
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::reference list<T>::emplace_front(Args &&...args) {
+  return *emplace(cbegin(), std::forward<Args>(args)...);
+}
+
+template <typename T>
+void list<T>::push_back(const_reference value) {
+  emplace_back(value);
+}
+
+template <typename T>
+void list<T>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
 }
 
 template <typename T>
 void list<T>::push_front(const_reference value) {
-  node *old_first = begin_;
-  node *new_node = new struct node(value, &end_, old_first);
-  old_first->prev_ = new_node;
-  begin_ = new_node;
-  end_.next_ = new_node;
-  ++size_;
+  emplace_front(value);
+}
+
+template <typename T>
+void list<T>::push_front(value_type &&value) {
+  emplace_front(std::move(value));
 }
 
+// Destroys the elements and, unless the pool is shared with another list,
+// hands all slabs back at once instead of returning nodes one by one.
 template <typename T>
 void list<T>::clear() {
-  for (; !empty();) pop_back();
+  if (pool_ != nullptr) pool_type::follow(pool_);
+  bool release = pool_.use_count() == 1;
+  node *next;
+  node *temp = begin_;
+  for (size_type i = 0; i < size_; temp = next, ++i) {
+    next = temp->next_;
+    if (release)
+      temp->~node();
+    else
+      destroy_node(temp);
+  }
+  if (release) pool_->release();
+  end_.prev_ = nullptr;
+  end_.next_ = nullptr;
+  begin_ = &end_;
+  size_ = 0;
+  invalidate_iterators();
 }
 
 template <typename T>
@@ -249,8 +397,9 @@ void list<T>::pop_back() {
       end_.next_ = nullptr;
       begin_ = &end_;
     }
-    delete old_last;
+    destroy_node(old_last);
     --size_;
+    invalidate_iterators();
   }
 }
 
@@ -267,46 +416,49 @@ void list<T>::pop_front() {
     end_.next_ = nullptr;
     begin_ = &end_;
   }
-  delete old_first;
+  destroy_node(old_first);
   --size_;
+  invalidate_iterators();
 }
 
 template <typename T>
 void list<T>::swap(list &other) {
-  node *last_this = end_.prev_;
-  node *last_other = other.end_.prev_;
-  last_this->next_ = &other.end_;
-  last_other->next_ = &end_;
-
-  begin_->prev_ = &other.end_;
-  other.begin_->prev_ = &end_;
-
   std::swap(size_, other.size_);
-  std::swap(node_, other.node_);
+  std::swap(pool_, other.pool_);
   std::swap(begin_, other.begin_);
-  std::swap(end_, other.end_);
+  std::swap(end_.prev_, other.end_.prev_);
+  std::swap(end_.next_, other.end_.next_);
+  adopt_nodes();
+  other.adopt_nodes();
+  invalidate_iterators();
+  other.invalidate_iterators();
 }
 
+// After the links of two lists were exchanged: points the first and last
+// node back at this list's own end_, or resets an empty list.
 template <typename T>
-typename list<T>::iterator list<T>::insert(iterator pos,
-                                           const_reference value) {
-  if (pos == begin()) {
-    push_front(value);
-    return begin();
-  } else if (pos == end()) {
-    push_back(value);
-    return --(end());
+void list<T>::adopt_nodes() noexcept {
+  if (size_ == 0) {
+    end_.prev_ = nullptr;
+    end_.next_ = nullptr;
+    begin_ = &end_;
   } else {
-    node *current = &pos;
-    node *prev_current = current->prev_;
-    node *new_insert = new struct node(value, prev_current, current);
-    prev_current->next_ = new_insert;
-    current->prev_ = new_insert;
-    ++size_;
-    return iterator(new_insert);
+    begin_->prev_ = &end_;
+    end_.prev_->next_ = &end_;
   }
 }
 
+template <typename T>
+typename list<T>::iterator list<T>::insert(iterator pos,
+                                           const_reference value) {
+  return emplace(const_iterator(&pos), value);
+}
+
+template <typename T>
+typename list<T>::iterator list<T>::insert(iterator pos, value_type &&value) {
+  return emplace(const_iterator(&pos), std::move(value));
+}
+
 template <typename T>
 typename list<T>::iterator list<T>::erase(iterator pos) {
   iterator first = pos;
@@ -323,15 +475,16 @@ typename list<T>::iterator list<T>::erase(iterator first, iterator last) {
   for (auto i = first; i != last; --size_) {
     del = &i;
     ++i;
-    delete del;
+    destroy_node(del);
   }
 
   if (&first == begin_) begin_ = next;
 
   prev->next_ = next;
   next->prev_ = prev;
+  invalidate_iterators();
 
-  return last;
+  return make_iterator(next);
 }
 
 template <typename T>
@@ -352,19 +505,41 @@ void list<T>::reverse() {
       i = next;
     }
 
+    std::swap(end_.next_, end_.prev_);
     begin_ = new_begin;
   }
 }
 
 template <typename T>
 void list<T>::splice(const_iterator pos, list &other) {
-  if (!other.empty()) {
-    iterator no_const_iterator = iterator(const_cast<node *>(&pos));
-    for (auto i = other.begin(); i != other.end(); ++i) {
-      insert(no_const_iterator, *i);
-    }
+  if (this != &other && !other.empty()) {
+    splice_nodes(const_cast<node *>(&pos), other, other.begin_,
+                 other.end_.prev_, other.size_);
+  }
+}
+
+template <typename T>
+void list<T>::splice(const_iterator pos, list &other, const_iterator it) {
+  node *where = const_cast<node *>(&pos);
+  node *moved = const_cast<node *>(&it);
+  if (where != moved && where != moved->next_) {
+    splice_nodes(where, other, moved, moved, 1);
   }
-  other.clear();
+}
+
+// Moving a range within one list keeps the size, so only a splice between
+// two lists walks the range to count it.
+template <typename T>
+void list<T>::splice(const_iterator pos, list &other, const_iterator first,
+                     const_iterator last) {
+  node *from = const_cast<node *>(&first);
+  node *to = const_cast<node *>(&last);
+  if (from == to) return;
+  size_type count = 0;
+  if (this != &other) {
+    for (node *i = from; i != to; i = i->next_) ++count;
+  }
+  splice_nodes(const_cast<node *>(&pos), other, from, to->prev_, count);
 }
 
 template <typename T>
@@ -382,74 +557,135 @@ void list<T>::unique() {
   }
 }
 
+// Bottom-up merge sort over the next_ links: bins[i] holds a sorted run of
+// 2^i nodes, so the sort needs O(log n) stack space, allocates nothing and
+// never copies an element. prev_ links are rebuilt in one final pass.
 template <typename T>
 void list<T>::sort() {
-  iterator end = this->end();
-  size_type count2 = 0;
-  for (; this->begin() != end; --end) {
-    bool swapped = false;
-
-    count2 = 0;
-    for (node *pos = begin_; pos != (&end)->prev_; pos = pos->next_, ++count2) {
-      node *next = pos->next_;
-      if (next->data_ < pos->data_) {
-        change_elements(iterator(pos), iterator(next));
-        pos = next;
-        swapped = true;
-      }
-      if (count2 > size_) {
-        throw std::logic_error("экстренный выход");
-      }
+  if (size_ < 2) return;
+  node *bins[64] = {};
+  end_.prev_->next_ = nullptr;
+  for (node *head = begin_; head != nullptr;) {
+    node *run = head;
+    head = head->next_;
+    run->next_ = nullptr;
+    size_type i = 0;
+    for (; bins[i] != nullptr; ++i) {
+      run = merge_chains(bins[i], run);
+      bins[i] = nullptr;
     }
+    bins[i] = run;
+  }
+  node *sorted = nullptr;
+  for (node *bin : bins) {
+    if (bin != nullptr) sorted = merge_chains(bin, sorted);
+  }
 
-    if (swapped == false) break;
+  node *prev = &end_;
+  for (node *i = sorted; i != nullptr; i = i->next_) {
+    i->prev_ = prev;
+    prev->next_ = i;
+    prev = i;
   }
+  prev->next_ = &end_;
+  end_.prev_ = prev;
+  begin_ = end_.next_;
 }
 
+// Walks both lists once, relinking each run of other's nodes that sorts
+// before the current node of this list. Equal elements of this list stay in
+// front, as with std::list::merge.
 template <typename T>
 void list<T>::merge(list &other) {
-  auto a = this->begin();
-  auto b = other.begin();
+  if (this == &other || other.empty()) return;
+  share_pool(other);
+  node *a = begin_;
+  while (!other.empty()) {
+    node *first = other.begin_;
+    while (a != &end_ && !(first->data_ < a->data_)) a = a->next_;
+    node *last = first;
+    size_type count = 1;
+    while (last->next_ != &other.end_ &&
+           (a == &end_ || last->next_->data_ < a->data_)) {
+      last = last->next_;
+      ++count;
+    }
+    other.unlink_nodes(first, last);
+    other.size_ -= count;
+    link_nodes(a, first, last);
+    size_ += count;
+  }
+  other.invalidate_iterators();
+}
 
-  for (; a != this->end() && b != other.end();) {
-    if (*b < *a) {
-      this->insert(a, *b);
-      ++b;
+template <typename T>
+typename list<T>::node *list<T>::merge_chains(node *first, node *second) {
+  node *head = nullptr;
+  node **tail = &head;
+  while (first != nullptr && second != nullptr) {
+    if (second->data_ < first->data_) {
+      *tail = second;
+      second = second->next_;
     } else {
-      ++a;
+      *tail = first;
+      first = first->next_;
     }
+    tail = &(*tail)->next_;
   }
+  *tail = (first != nullptr) ? first : second;
+  return head;
+}
 
-  for (; b != other.end(); ++b) this->insert(a, *b);
-};
+template <typename T>
+void list<T>::link_nodes(node *pos, node *first, node *last) {
+  node *prev = (end_.prev_ == nullptr) ? &end_ : pos->prev_;
+  prev->next_ = first;
+  first->prev_ = prev;
+  last->next_ = pos;
+  pos->prev_ = last;
+  begin_ = end_.next_;
+}
 
 template <typename T>
-typename list<T>::iterator list<T>::change_elements(iterator a, iterator b) {
-  node *self_a = &a;
-  node *neig_a_prev = self_a->prev_;
-  node *neig_a_next = self_a->next_;
-  node *self_b = &b;
-  node *neig_b_prev = self_b->prev_;
-  node *neig_b_next = self_b->next_;
+void list<T>::unlink_nodes(node *first, node *last) {
+  node *prev = first->prev_;
+  node *next = last->next_;
+  prev->next_ = next;
+  next->prev_ = prev;
+  if (end_.next_ == &end_) {
+    end_.next_ = nullptr;
+    end_.prev_ = nullptr;
+  }
+  begin_ = (end_.next_ != nullptr) ? end_.next_ : &end_;
+}
 
-  if (neig_a_next == self_b) {
-    self_a->prev_ = self_b;
-    self_b->next_ = self_a;
-    self_b->prev_ = neig_a_prev;
-    self_a->next_ = neig_b_next;
+// Moves the nodes [first, last] of other in front of pos.
+template <typename T>
+void list<T>::splice_nodes(node *pos, list &other, node *first, node *last,
+                           size_type count) {
+  share_pool(other);
+  other.unlink_nodes(first, last);
+  other.size_ -= count;
+  link_nodes(pos, first, last);
+  size_ += count;
+  other.invalidate_iterators();
+}
 
-    neig_a_prev->next_ = self_b;
-    neig_b_next->prev_ = self_a;
+// Makes both lists allocate from one pool so that nodes can move between
+// them. other's pool is folded into this one's and forwards to it, so lists
+// that share it with other keep working.
+template <typename T>
+void list<T>::share_pool(list &other) {
+  if (pool_ != nullptr) pool_type::follow(pool_);
+  if (other.pool_ != nullptr) pool_type::follow(other.pool_);
+  if (pool_ == other.pool_) return;
+  if (pool_ == nullptr) {
+    pool_ = other.pool_;
   } else {
-    std::swap(self_a->next_, self_b->next_);
-    std::swap(self_a->prev_, self_b->prev_);
-    std::swap(neig_a_prev->next_, neig_b_prev->next_);
-    std::swap(neig_a_next->prev_, neig_b_next->prev_);
+    if (other.pool_ != nullptr) pool_type::absorb(pool_, *other.pool_);
+    other.pool_ = pool_;
   }
-  if (self_a == begin_) begin_ = self_b;
-
-  return iterator(self_b);
-};
+}
 
 }  // namespace myn
 
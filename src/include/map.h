@@ -4,16 +4,27 @@
 #include "set.h"
 
 namespace myn {
-template <class Key, class T>
-class map : public set<std::pair<Key, T>> {
+template <class Key, class T, bool Ranked = false>
+class map : public set<std::pair<Key, T>, Ranked> {
+  using base = set<std::pair<Key, T>, Ranked>;
+
  public:
   using key_type = Key;
   using mapped_type = T;
   using value_type = std::pair<key_type, mapped_type>;
-  using iterator = typename set<value_type>::iterator;
-  using const_iterator = typename set<value_type>::const_iterator;
+  using size_type = typename base::size_type;
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+  using node_type = typename base::node_type;
+  using insert_return_type = typename base::insert_return_type;
 
-  using set<value_type>::set;
+  using base::base;
+  // Builds in the body rather than through set's constructor, where the
+  // key-only comparison of map is not yet in effect.
+  template <class InputIt>
+  map(InputIt first, InputIt last) {
+    base::assign(first, last);
+  }
 
   // map();
   // map(std::initializer_list<value_type> const &list);
@@ -28,7 +39,7 @@ class map : public set<std::pair<Key, T>> {
       throw std::out_of_range("key not found");
     } else {
       mapped_type data{};
-      return set<value_type>::find(std::make_pair(key, data))->second;
+      return base::find(std::make_pair(key, data))->second;
     }
   }
   mapped_type &operator[](const key_type &key) {
@@ -36,7 +47,7 @@ class map : public set<std::pair<Key, T>> {
     if (!contains(key)) {
       insert(key, data);
     }
-    return set<value_type>::find(std::make_pair(key, data))->second;
+    return base::find(std::make_pair(key, data))->second;
   }
 
   // iterator begin();
@@ -50,15 +61,22 @@ class map : public set<std::pair<Key, T>> {
 
   // void clear();
   std::pair<iterator, bool> insert(const value_type &value) {
-    return set<value_type>::base_insert(value);
+    return base::base_insert(value);
   }
   std::pair<iterator, bool> insert(const key_type &key,
                                    const mapped_type &obj) {
-    return set<value_type>::base_insert(std::make_pair(key, obj));
+    return base::base_insert(std::make_pair(key, obj));
+  }
+  insert_return_type insert(node_type &&node) {
+    return base::insert(std::move(node));
+  }
+  using base::extract;
+  node_type extract(const key_type &key) {
+    return base::extract(std::make_pair(key, mapped_type{}));
   }
   std::pair<iterator, bool> insert_or_assign(const Key &key,
                                              const mapped_type &obj) {
-    return set<value_type>::base_insert(std::make_pair(key, obj), true);
+    return base::base_insert(std::make_pair(key, obj), true);
   }
   // void erase(iterator pos);
   // void swap(map &other);
@@ -66,7 +84,31 @@ class map : public set<std::pair<Key, T>> {
 
   bool contains(const key_type &key) {
     mapped_type data{};
-    return set<value_type>::contains(std::make_pair(key, data));
+    return base::contains(std::make_pair(key, data));
+  }
+  iterator lower_bound(const key_type &key) const {
+    return base::lower_bound(std::make_pair(key, mapped_type{}));
+  }
+  iterator upper_bound(const key_type &key) const {
+    return base::upper_bound(std::make_pair(key, mapped_type{}));
+  }
+  std::pair<iterator, iterator> equal_range(const key_type &key) const {
+    return base::equal_range(std::make_pair(key, mapped_type{}));
+  }
+  // Calls fn(element) for the keys in [lo, hi), in order.
+  template <class F>
+  void for_each_in_range(const key_type &lo, const key_type &hi, F fn) {
+    base::for_each_in_range(std::make_pair(lo, mapped_type{}),
+                            std::make_pair(hi, mapped_type{}), fn);
+  }
+
+  // Ranked maps only; see set.
+  size_type rank(const key_type &key) const {
+    return base::rank(std::make_pair(key, mapped_type{}));
+  }
+  size_type count_range(const key_type &lo, const key_type &hi) const {
+    return base::count_range(std::make_pair(lo, mapped_type{}),
+                             std::make_pair(hi, mapped_type{}));
   }
 
  private:
@@ -76,6 +118,28 @@ class map : public set<std::pair<Key, T>> {
   }
 };
 
+// The set algebra of set.h, keyed on the keys alone, giving maps. The
+// output iterator forms apply to maps as they are.
+template <class Key, class T, bool Ranked>
+map<Key, T, Ranked> set_union(const map<Key, T, Ranked> &a,
+                              const map<Key, T, Ranked> &b) {
+  return set_combined(a, b, set_operation::kUnion);
+}
+template <class Key, class T, bool Ranked>
+map<Key, T, Ranked> set_intersection(const map<Key, T, Ranked> &a,
+                                     const map<Key, T, Ranked> &b) {
+  return set_combined(a, b, set_operation::kIntersection);
+}
+template <class Key, class T, bool Ranked>
+map<Key, T, Ranked> set_difference(const map<Key, T, Ranked> &a,
+                                   const map<Key, T, Ranked> &b) {
+  return set_combined(a, b, set_operation::kDifference);
+}
+template <class Key, class T, bool Ranked>
+map<Key, T, Ranked> set_symmetric_difference(const map<Key, T, Ranked> &a,
+                                             const map<Key, T, Ranked> &b) {
+  return set_combined(a, b, set_operation::kSymmetricDifference);
+}
 };  // namespace myn
 
 #endif  // SRC_INCLUDE_MAP_H_
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef SRC_INCLUDE_MPMC_QUEUE_H_
+#define SRC_INCLUDE_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace myn {
+// Bounded queue for any number of producers and consumers (Vyukov). Every
+// slot carries a sequence number that tells which lap of the ring it is
+// ready for: a producer may fill slot i on lap L once its sequence is
+// L * capacity + i, and publishes the element by bumping it by one; a
+// consumer may empty it once the sequence is that plus one, and hands the
+// slot to the next lap by setting it to (L + 1) * capacity + i. Producers
+// and consumers claim positions with a CAS on their own counter, so they
+// never contend with each other, and an element is copied exactly once in
+// and once out.
+template <typename T>
+class mpmc_queue {
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+  // capacity is rounded up to a power of two.
+  explicit mpmc_queue(size_type capacity) {
+    size_type rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+    mask_ = rounded - 1;
+    slots_ = slot_traits::allocate(slot_alloc_, rounded);
+    for (size_type i = 0; i < rounded; ++i) {
+      slot_traits::construct(slot_alloc_, slots_ + i, i);
+    }
+  }
+  mpmc_queue(const mpmc_queue &) = delete;
+  mpmc_queue &operator=(const mpmc_queue &) = delete;
+  ~mpmc_queue() {
+    size_type tail = tail_.load(std::memory_order_relaxed);
+    for (size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+      slots_[i & mask_].value()->~T();
+    }
+    for (size_type i = 0; i <= mask_; ++i) {
+      slot_traits::destroy(slot_alloc_, slots_ + i);
+    }
+    slot_traits::deallocate(slot_alloc_, slots_, mask_ + 1);
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+  // Snapshot; may be off while other threads are pushing or popping.
+  size_type size() const noexcept {
+    size_type tail = tail_.load(std::memory_order_relaxed);
+    size_type head = head_.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+  bool empty() const noexcept { return size() == 0; }
+
+  // Return false if the queue is full. The element is constructed in its
+  // slot after the slot has been claimed, so its constructor must not
+  // throw.
+  bool try_push(const_reference value) { return try_emplace(value); }
+  bool try_push(value_type &&value) { return try_emplace(std::move(value)); }
+  template <typename... Args>
+  bool try_emplace(Args &&...args);
+  // Returns false if the queue is empty.
+  bool try_pop(reference value);
+
+ private:
+  struct alignas(64) Slot {
+    explicit Slot(size_type sequence) : sequence_(sequence) {}
+    T *value() { return std::launder(reinterpret_cast<T *>(storage_)); }
+    std::atomic<size_type> sequence_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+  };
+  using slot_allocator = std::allocator<Slot>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+
+  slot_allocator slot_alloc_;
+  Slot *slots_;
+  size_type mask_;
+  // Next position to fill and next position to empty, each on its own line.
+  alignas(64) std::atomic<size_type> tail_{0};
+  alignas(64) std::atomic<size_type> head_{0};
+};
+
+template <typename T>
+template <typename... Args>
+bool mpmc_queue<T>::try_emplace(Args &&...args) {
+  size_type pos = tail_.load(std::memory_order_relaxed);
+  Slot *slot;
+  while (true) {
+    slot = slots_ + (pos & mask_);
+    size_type sequence = slot->sequence_.load(std::memory_order_acquire);
+    auto lag = static_cast<std::ptrdiff_t>(sequence - pos);
+    if (lag == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (lag < 0) {
+      // The slot still holds last lap's element: the queue is full.
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+  ::new (static_cast<void *>(slot->storage_)) T(std::forward<Args>(args)...);
+  slot->sequence_.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool mpmc_queue<T>::try_pop(reference value) {
+  size_type pos = head_.load(std::memory_order_relaxed);
+  Slot *slot;
+  while (true) {
+    slot = slots_ + (pos & mask_);
+    size_type sequence = slot->sequence_.load(std::memory_order_acquire);
+    auto lag = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+    if (lag == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (lag < 0) {
+      // Nothing has been published in this slot yet: the queue is empty.
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+  T *element = slot->value();
+  value = std::move(*element);
+  element->~T();
+  slot->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_MPMC_QUEUE_H_
@@ -0,0 +1,178 @@
+#ifndef SRC_INCLUDE_NODE_POOL_H_
+#define SRC_INCLUDE_NODE_POOL_H_
+
+#include <cstddef>
+#include <memory>
+
+namespace myn {
+// Fixed-size node allocator: memory comes from slabs that double in size up
+// to kMaxSlab nodes, freed nodes go to an intrusive free list and are reused
+// before a slab is touched again, and release() returns every slab at once.
+// The pool only hands out raw storage; callers construct and destroy the
+// nodes themselves. Not thread-safe: lists sharing a pool must stay on one
+// thread.
+//
+// A pool folded into another by absorb() gives up its slabs and forwards to
+// the other one; its owners call follow() to reach the pool that now holds
+// their nodes.
+template <class T>
+class node_pool {
+ public:
+  using size_type = std::size_t;
+
+  node_pool() noexcept = default;
+  node_pool(const node_pool &) = delete;
+  node_pool &operator=(const node_pool &) = delete;
+  ~node_pool() { release(); }
+
+  T *allocate() {
+    Slot *slot = free_;
+    if (slot != nullptr) {
+      free_ = slot->next_;
+      if (free_ == nullptr) free_tail_ = nullptr;
+    } else {
+      if (unused_ == unused_end_) next_range();
+      slot = unused_++;
+    }
+    return reinterpret_cast<T *>(slot->storage_);
+  }
+
+  void deallocate(T *node) noexcept {
+    Slot *slot = reinterpret_cast<Slot *>(node);
+    slot->next_ = free_;
+    if (free_ == nullptr) free_tail_ = slot;
+    free_ = slot;
+  }
+
+  // Frees every slab. Nodes still handed out become dangling, so the caller
+  // must have destroyed them first.
+  void release() noexcept {
+    while (slabs_ != nullptr) {
+      Slab *next = slabs_->next_;
+      allocator_.deallocate(reinterpret_cast<Slot *>(slabs_),
+                            kHeaderSlots + slabs_->capacity_);
+      slabs_ = next;
+    }
+    free_ = free_tail_ = unused_ = unused_end_ = nullptr;
+    current_ = spare_ = nullptr;
+    capacity_ = 0;
+  }
+
+  // Takes over other's slabs and free nodes, so nodes allocated by other may
+  // from now on be returned to this pool. other is left empty. O(slabs of
+  // other): the free lists are joined through their tails, and other's
+  // untouched slab ranges are kept for later allocations as they are.
+  void merge(node_pool &other) noexcept {
+    if (this == &other || other.slabs_ == nullptr) return;
+    other.park();
+    Slab *last = other.slabs_;
+    while (last->next_ != nullptr) last = last->next_;
+    last->next_ = slabs_;
+    slabs_ = other.slabs_;
+    while (other.spare_ != nullptr) {
+      Slab *slab = other.spare_;
+      other.spare_ = slab->next_spare_;
+      slab->next_spare_ = spare_;
+      spare_ = slab;
+    }
+    if (other.free_ != nullptr) {
+      other.free_tail_->next_ = free_;
+      if (free_ == nullptr) free_tail_ = other.free_tail_;
+      free_ = other.free_;
+    }
+    capacity_ += other.capacity_;
+    other.slabs_ = nullptr;
+    other.free_ = other.free_tail_ = nullptr;
+    other.capacity_ = 0;
+  }
+
+  // Merges other into *pool and leaves other forwarding to it.
+  static void absorb(const std::shared_ptr<node_pool> &pool,
+                     node_pool &other) noexcept {
+    pool->merge(other);
+    other.forward_ = pool;
+  }
+
+  // Moves pool along the forwarding chain to the pool that holds its slabs.
+  static void follow(std::shared_ptr<node_pool> &pool) noexcept {
+    while (pool->forward_ != nullptr) {
+      std::shared_ptr<node_pool> next = pool->forward_;
+      pool = std::move(next);
+    }
+  }
+
+  // Number of nodes the current slabs can hold.
+  size_type capacity() const noexcept { return capacity_; }
+
+ private:
+  union Slot {
+    Slot *next_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+  };
+  // The untouched range of a slab is kept in its header while the slab
+  // waits on the spare list.
+  struct Slab {
+    Slab *next_;
+    size_type capacity_;
+    Slab *next_spare_;
+    Slot *unused_;
+    Slot *unused_end_;
+  };
+
+  static constexpr size_type kMinSlab = 16;
+  static constexpr size_type kMaxSlab = 4096;
+  static constexpr size_type kHeaderSlots =
+      (sizeof(Slab) + sizeof(Slot) - 1) / sizeof(Slot);
+
+  // Moves on to a spare slab's untouched range, or to a new slab.
+  void next_range() {
+    if (spare_ == nullptr) {
+      grow();
+      return;
+    }
+    current_ = spare_;
+    spare_ = current_->next_spare_;
+    unused_ = current_->unused_;
+    unused_end_ = current_->unused_end_;
+  }
+
+  void grow() {
+    size_type count = capacity_ < kMinSlab ? kMinSlab : capacity_;
+    if (count > kMaxSlab) count = kMaxSlab;
+    Slot *memory = allocator_.allocate(kHeaderSlots + count);
+    Slab *slab = reinterpret_cast<Slab *>(memory);
+    slab->next_ = slabs_;
+    slab->capacity_ = count;
+    slabs_ = slab;
+    current_ = slab;
+    unused_ = memory + kHeaderSlots;
+    unused_end_ = unused_ + count;
+    capacity_ += count;
+  }
+
+  // Puts the current slab's untouched range, if any, on the spare list.
+  void park() noexcept {
+    if (unused_ != unused_end_) {
+      current_->unused_ = unused_;
+      current_->unused_end_ = unused_end_;
+      current_->next_spare_ = spare_;
+      spare_ = current_;
+    }
+    current_ = nullptr;
+    unused_ = unused_end_ = nullptr;
+  }
+
+  std::allocator<Slot> allocator_;
+  Slab *slabs_ = nullptr;
+  Slab *current_ = nullptr;
+  Slab *spare_ = nullptr;
+  Slot *free_ = nullptr;
+  Slot *free_tail_ = nullptr;
+  Slot *unused_ = nullptr;
+  Slot *unused_end_ = nullptr;
+  size_type capacity_ = 0;
+  std::shared_ptr<node_pool> forward_;
+};
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_NODE_POOL_H_
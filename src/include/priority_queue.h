@@ -0,0 +1,182 @@
+#ifndef SRC_INCLUDE_PRIORITY_QUEUE_H_
+#define SRC_INCLUDE_PRIORITY_QUEUE_H_
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.h"
+
+namespace myn {
+// Max-heap adapter (the top is the largest element under Compare, as with
+// std::priority_queue) over any random-access container with operator[],
+// size, emplace_back, back and pop_back.
+//
+// Arity is the number of children per node. A wider heap is shallower, so
+// push does fewer moves, and the children of a node lie next to each other
+// in memory: a 4- or 8-ary heap of small elements reads one or two cache
+// lines per level of pop where a binary heap reads one per level, over
+// twice as many levels.
+//
+// push_bulk appends a range and, when the range is at least as large as the
+// heap already was, restores the heap bottom-up in O(n) rather than sifting
+// each element up in O(log n).
+template <typename T, class Container = vector<T>,
+          class Compare = std::less<T>, size_t Arity = 2>
+class priority_queue {
+  static_assert(Arity >= 2, "a heap node needs at least two children");
+
+ public:
+  using container_type = Container;
+  using value_compare = Compare;
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+  static constexpr size_type arity = Arity;
+
+  priority_queue() {}
+  explicit priority_queue(const Compare &comp) : comp_(comp) {}
+  priority_queue(const Compare &comp, const container_type &c)
+      : c_(c), comp_(comp) {
+    make_heap();
+  }
+  priority_queue(const Compare &comp, container_type &&c)
+      : c_(std::move(c)), comp_(comp) {
+    make_heap();
+  }
+  template <class InputIt>
+  priority_queue(InputIt first, InputIt last, const Compare &comp = Compare())
+      : comp_(comp) {
+    push_bulk(first, last);
+  }
+  priority_queue(std::initializer_list<value_type> const &items)
+      : priority_queue(items.begin(), items.end()) {}
+
+  const_reference top() const {
+    check_not_empty();
+    return c_[0];
+  }
+
+  bool empty() const noexcept { return c_.size() == 0; }
+  size_type size() const noexcept { return c_.size(); }
+
+  void push(const_reference value) { emplace(value); }
+  void push(value_type &&value) { emplace(std::move(value)); }
+  template <typename... Args>
+  void emplace(Args &&...args) {
+    c_.emplace_back(std::forward<Args>(args)...);
+    sift_up(c_.size() - 1);
+  }
+
+  template <class InputIt>
+  void push_bulk(InputIt first, InputIt last);
+
+  void pop() {
+    check_not_empty();
+    if (c_.size() > 1) {
+      value_type value = std::move(c_.back());
+      c_.pop_back();
+      refill_root(std::move(value));
+    } else {
+      c_.pop_back();
+    }
+  }
+
+  void swap(priority_queue &other) noexcept {
+    c_.swap(other.c_);
+    std::swap(comp_, other.comp_);
+  }
+
+ private:
+  static size_type parent(size_type i) { return (i - 1) / Arity; }
+  static size_type first_child(size_type i) { return i * Arity + 1; }
+
+  // Both sifts carry the moving element in a local and shift the others
+  // over the hole, one move per level instead of a three-move swap.
+  void sift_up(size_type i) {
+    if (i == 0) return;
+    value_type value = std::move(c_[i]);
+    while (i > 0 && comp_(c_[parent(i)], value)) {
+      c_[i] = std::move(c_[parent(i)]);
+      i = parent(i);
+    }
+    c_[i] = std::move(value);
+  }
+
+  void sift_down(size_type i) {
+    const size_type n = c_.size();
+    value_type value = std::move(c_[i]);
+    while (true) {
+      size_type child = first_child(i);
+      if (child >= n) break;
+      size_type last = child + Arity < n ? child + Arity : n;
+      size_type best = child;
+      for (++child; child < last; ++child) {
+        if (comp_(c_[best], c_[child])) best = child;
+      }
+      if (!comp_(value, c_[best])) break;
+      c_[i] = std::move(c_[best]);
+      i = best;
+    }
+    c_[i] = std::move(value);
+  }
+
+  // Puts value in place of the removed top. The value comes from the
+  // bottom of the heap, so it almost always belongs near the bottom again:
+  // rather than compare it on the way down, move the hole along the larger
+  // children all the way to a leaf, then sift value up from there. That
+  // saves one comparison per level.
+  void refill_root(value_type &&value) {
+    const size_type n = c_.size();
+    size_type i = 0;
+    while (true) {
+      size_type child = first_child(i);
+      if (child >= n) break;
+      size_type last = child + Arity < n ? child + Arity : n;
+      size_type best = child;
+      for (++child; child < last; ++child) {
+        if (comp_(c_[best], c_[child])) best = child;
+      }
+      c_[i] = std::move(c_[best]);
+      i = best;
+    }
+    c_[i] = std::move(value);
+    sift_up(i);
+  }
+
+  // Floyd's bottom-up construction: sift down every inner node, last first.
+  void make_heap() {
+    const size_type n = c_.size();
+    if (n < 2) return;
+    for (size_type i = parent(n - 1) + 1; i-- > 0;) sift_down(i);
+  }
+
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("priority_queue is empty");
+    }
+  }
+
+  container_type c_;
+  Compare comp_;
+};
+
+template <typename T, class Container, class Compare, size_t Arity>
+template <class InputIt>
+void priority_queue<T, Container, Compare, Arity>::push_bulk(InputIt first,
+                                                             InputIt last) {
+  const size_type old_size = c_.size();
+  for (; first != last; ++first) c_.emplace_back(*first);
+  const size_type added = c_.size() - old_size;
+  if (added >= old_size) {
+    make_heap();
+  } else {
+    for (size_type i = old_size; i < c_.size(); ++i) sift_up(i);
+  }
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_PRIORITY_QUEUE_H_
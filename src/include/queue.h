@@ -1,7 +1,16 @@
 #ifndef SRC_INCLUDE_QUEUE_H_
 #define SRC_INCLUDE_QUEUE_H_
 
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
 namespace myn {
+// FIFO queue over a growable circular buffer. Elements sit in one array,
+// push writes behind the tail and pop advances the head, so once the buffer
+// is large enough for the working set push and pop never allocate. The
+// capacity is a power of two and doubles when the buffer is full.
 template <typename T>
 class queue {
  public:
@@ -12,32 +21,27 @@ class queue {
 
   queue() noexcept {}
 
-  queue(std::initializer_list<value_type> const& items) noexcept {
-    for (const auto item : items) {
+  queue(std::initializer_list<value_type> const& items) {
+    reserve(items.size());
+    for (const auto& item : items) {
       push(item);
     }
   }
 
   queue(const queue& q) {
-    Node* current = q.head_;
-    queue temp;
-    while (current) {
-      temp.push(current->value);
-      current = current->ptr_next_;
-    }
-    while (!temp.empty()) {
-      push(temp.front());
-      temp.pop();
+    reserve(q.size_);
+    for (size_type i = 0; i < q.size_; ++i) {
+      traits::construct(alloc_, data_ + i, q.data_[q.slot(i)]);
+      ++size_;
     }
   }
 
-  queue(queue&& q) noexcept : head_(q.head_), tail_(q.tail_), size_(q.size_) {
-    q.head_ = nullptr;
-    q.tail_ = nullptr;
-    q.size_ = 0;
-  }
+  queue(queue&& q) noexcept { swap(q); }
 
-  ~queue() { delete_queue(); }
+  ~queue() {
+    clear();
+    traits::deallocate(alloc_, data_, capacity_);
+  }
 
   queue& operator=(const queue& q) {
     if (this != &q) {
@@ -49,86 +53,138 @@ class queue {
 
   queue& operator=(queue&& q) noexcept {
     if (this != &q) {
-      delete_queue();
-      head_ = q.head_;
-      tail_ = q.tail_;
-      size_ = q.size_;
-      q.head_ = nullptr;
-      q.tail_ = nullptr;
-      q.size_ = 0;
+      queue temp(std::move(q));
+      swap(temp);
     }
     return *this;
   }
 
+  reference front() {
+    check_not_empty();
+    return data_[head_];
+  }
   const_reference front() const {
-    if (empty()) {
-      throw std::logic_error("queue is empty");
-    }
-    return head_->value;
+    check_not_empty();
+    return data_[head_];
+  }
+  reference back() {
+    check_not_empty();
+    return data_[slot(size_ - 1)];
   }
-
   const_reference back() const {
-    if (empty()) {
-      throw std::logic_error("queue is empty");
-    }
-    return tail_->value;
+    check_not_empty();
+    return data_[slot(size_ - 1)];
   }
 
   bool empty() const noexcept { return size_ == 0; }
   size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
 
-  void push(const_reference value) noexcept {
-    Node* new_node = new Node(value);
-    if (empty()) {
-      head_ = new_node;
-      tail_ = new_node;
-    } else {
-      tail_->ptr_next_ = new_node;
-      tail_ = new_node;
-    }
-    ++size_;
+  // Makes room for n elements without further allocation.
+  void reserve(size_type n) {
+    if (n > capacity_) reallocate(n);
   }
 
+  void push(const_reference value) { emplace(value); }
+  void push(value_type&& value) { emplace(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace(Args&&... args);
+
   void pop() {
-    if (empty()) {
-      throw std::logic_error("queue is empty");
-    }
-    Node* old_H_ead = head_;
-    head_ = head_->ptr_next_;
-    delete old_H_ead;
+    check_not_empty();
+    traits::destroy(alloc_, data_ + head_);
+    head_ = (head_ + 1) & (capacity_ - 1);
     --size_;
   }
 
+  void clear() noexcept {
+    for (size_type i = 0; i < size_; ++i) {
+      traits::destroy(alloc_, data_ + slot(i));
+    }
+    head_ = 0;
+    size_ = 0;
+  }
+
   void swap(queue& q) noexcept {
+    std::swap(data_, q.data_);
+    std::swap(capacity_, q.capacity_);
     std::swap(head_, q.head_);
-    std::swap(tail_, q.tail_);
     std::swap(size_, q.size_);
   }
 
   template <typename... Args>
   void insert_many_back(Args&&... args) {
+    reserve(size_ + sizeof...(Args));
     (push(std::forward<Args>(args)), ...);
   }
 
  private:
-  struct Node {
-    value_type value;
-    Node* ptr_next_;
+  using allocator_type = std::allocator<T>;
+  using traits = std::allocator_traits<allocator_type>;
 
-    explicit Node(value_type val) noexcept : value(val), ptr_next_(nullptr) {}
-  };
+  static constexpr size_type kMinCapacity = 8;
 
-  Node* head_ = nullptr;
-  Node* tail_ = nullptr;
+  allocator_type alloc_;
+  T* data_ = nullptr;
+  size_type capacity_ = 0;
+  size_type head_ = 0;
   size_type size_ = 0;
 
-  void delete_queue() {
-    while (!empty()) {
-      pop();
+  // Buffer index of the i-th element from the front.
+  size_type slot(size_type i) const noexcept {
+    return (head_ + i) & (capacity_ - 1);
+  }
+
+  // Moves the elements, in order, to the front of a new buffer of at least
+  // n slots.
+  void reallocate(size_type n) {
+    size_type capacity = kMinCapacity;
+    while (capacity < n) capacity *= 2;
+    T* data = traits::allocate(alloc_, capacity);
+    size_type moved = 0;
+    try {
+      for (; moved < size_; ++moved) {
+        traits::construct(alloc_, data + moved,
+                          std::move_if_noexcept(data_[slot(moved)]));
+      }
+    } catch (...) {
+      for (size_type i = 0; i < moved; ++i) traits::destroy(alloc_, data + i);
+      traits::deallocate(alloc_, data, capacity);
+      throw;
+    }
+    for (size_type i = 0; i < size_; ++i) {
+      traits::destroy(alloc_, data_ + slot(i));
+    }
+    traits::deallocate(alloc_, data_, capacity_);
+    data_ = data;
+    capacity_ = capacity;
+    head_ = 0;
+  }
+
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("queue is empty");
     }
   }
 };
 
+template <typename T>
+template <typename... Args>
+typename queue<T>::reference queue<T>::emplace(Args&&... args) {
+  if (size_ == capacity_) {
+    // The arguments may refer into this queue, so build the element before
+    // the buffer moves.
+    value_type value(std::forward<Args>(args)...);
+    reallocate(size_ + 1);
+    traits::construct(alloc_, data_ + slot(size_), std::move(value));
+  } else {
+    traits::construct(alloc_, data_ + slot(size_),
+                      std::forward<Args>(args)...);
+  }
+  return data_[slot(size_++)];
+}
+
 }  // namespace myn
 
-#endif  // SRC_INCLUDE_QUEUE_H_
\ No newline at end of file
+#endif  // SRC_INCLUDE_QUEUE_H_
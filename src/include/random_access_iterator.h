@@ -3,6 +3,8 @@
 
 #include <memory>
 
+#include "checked_iterator.h"
+
 namespace myn {
 template <class T>
 class RandomAccessIterator {
@@ -14,9 +16,17 @@ class RandomAccessIterator {
   using iterator_category = std::random_access_iterator_tag;
   RandomAccessIterator() = default;
   RandomAccessIterator(pointer iter) : iter_(iter){};
-  reference operator*() const { return *iter_; };
+#ifdef MYN_CHECKED_ITERATORS
+  RandomAccessIterator(pointer iter, const iterator_guard<T>* guard)
+      : iter_(iter), guard_(guard), generation_(guard->generation()){};
+#endif
+  reference operator*() const {
+    check_position(iter_, false);
+    return *iter_;
+  };
   RandomAccessIterator& operator++() {
     ++iter_;
+    check_position(iter_, true);
     return *this;
   }
   RandomAccessIterator operator++(int) {
@@ -26,6 +36,7 @@ class RandomAccessIterator {
   }
   RandomAccessIterator& operator--() {
     --iter_;
+    check_position(iter_, true);
     return *this;
   }
   RandomAccessIterator operator--(int) {
@@ -40,6 +51,7 @@ class RandomAccessIterator {
     } else {
       while (dist++) --iter_;
     }
+    check_position(iter_, true);
     return *this;
   };
   friend RandomAccessIterator& operator-=(RandomAccessIterator it,
@@ -53,12 +65,16 @@ class RandomAccessIterator {
   };
   RandomAccessIterator& operator-=(difference_type diff) {
     iter_ -= diff;
+    check_position(iter_, true);
     return *this;
   };
   difference_type operator-(const RandomAccessIterator& rhs) const {
     return iter_ - rhs.iter_;
   };
-  reference operator[](difference_type diff) { return *(iter_ + diff); };
+  reference operator[](difference_type diff) {
+    check_position(iter_ + diff, false);
+    return *(iter_ + diff);
+  };
   bool operator<(const RandomAccessIterator& other) const {
     return other.iter_ - iter_ > 0;
   };
@@ -80,6 +96,23 @@ class RandomAccessIterator {
 
  private:
   pointer iter_;
+#ifdef MYN_CHECKED_ITERATORS
+  const iterator_guard<T>* guard_ = nullptr;
+  std::size_t generation_ = 0;
+#endif
+
+  // Traps on stale iterators and on positions outside [begin, end] (or
+  // [begin, end) for dereference). Empty unless MYN_CHECKED_ITERATORS is set.
+  void check_position([[maybe_unused]] const T* position,
+                      [[maybe_unused]] bool allow_end) const {
+#ifdef MYN_CHECKED_ITERATORS
+    if (guard_ == nullptr) return;
+    check_iterator_generation(guard_->generation(), generation_);
+    check_iterator_range(position >= guard_->first() &&
+                         (position < guard_->last() ||
+                          (allow_end && position == guard_->last())));
+#endif
+  }
 };
 
 template <class T>
@@ -95,9 +128,15 @@ class constRandomAccessIterator {
 
   constRandomAccessIterator() = default;
   constRandomAccessIterator(const_iterator iter) : iter_(iter) {}
+#ifdef MYN_CHECKED_ITERATORS
+  constRandomAccessIterator(const_iterator iter,
+                            const iterator_guard<T>* guard)
+      : iter_(iter), guard_(guard), generation_(guard->generation()) {}
+#endif
 
   constRandomAccessIterator& operator++() {
     ++iter_;
+    check_position(iter_, true);
     return *this;
   }
   constRandomAccessIterator operator++(int) {
@@ -107,6 +146,7 @@ class constRandomAccessIterator {
   }
   constRandomAccessIterator& operator--() {
     --iter_;
+    check_position(iter_, true);
     return *this;
   }
   constRandomAccessIterator operator--(int) {
@@ -121,6 +161,7 @@ class constRandomAccessIterator {
     } else {
       while (dist++) --iter_;
     }
+    check_position(iter_, true);
     return *this;
   };
   friend constRandomAccessIterator& operator-=(constRandomAccessIterator it,
@@ -134,12 +175,16 @@ class constRandomAccessIterator {
   };
   constRandomAccessIterator& operator-=(difference_type diff) {
     iter_ -= diff;
+    check_position(iter_, true);
     return *this;
   };
   difference_type operator-(const constRandomAccessIterator& rhs) const {
     return iter_ - rhs.iter_;
   };
-  const_reference operator[](difference_type diff) { return *(iter_ + diff); };
+  const_reference operator[](difference_type diff) {
+    check_position(iter_ + diff, false);
+    return *(iter_ + diff);
+  };
   bool operator<(const constRandomAccessIterator& other) const {
     return other.iter_ - iter_ > 0;
   };
@@ -161,6 +206,21 @@ class constRandomAccessIterator {
 
  private:
   const_iterator iter_;
+#ifdef MYN_CHECKED_ITERATORS
+  const iterator_guard<T>* guard_ = nullptr;
+  std::size_t generation_ = 0;
+#endif
+
+  void check_position([[maybe_unused]] const T* position,
+                      [[maybe_unused]] bool allow_end) const {
+#ifdef MYN_CHECKED_ITERATORS
+    if (guard_ == nullptr) return;
+    check_iterator_generation(guard_->generation(), generation_);
+    check_iterator_range(position >= guard_->first() &&
+                         (position < guard_->last() ||
+                          (allow_end && position == guard_->last())));
+#endif
+  }
 };
 }  // namespace myn
 
@@ -1,13 +1,55 @@
 #ifndef SRC_INCLUDE_SET_H_
 #define SRC_INCLUDE_SET_H_
 
+#include <algorithm>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "checked_iterator.h"
 #include "vector.h"
 
 namespace myn {
-template <class T>
+// Subtree size carried by the nodes of a ranked set; empty otherwise.
+template <bool Ranked>
+struct set_node_count {};
+template <>
+struct set_node_count<true> {
+  std::size_t count_ = 1;
+};
+
+// The operations of set_combine, below the set.
+enum class set_operation {
+  kUnion,
+  kIntersection,
+  kDifference,
+  kSymmetricDifference
+};
+
+template <class T, bool Ranked>
+class set;
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_combine(const set<T, Ranked>& a, const set<T, Ranked>& b,
+                     set_operation op, OutputIt out);
+
+// Ordered set over a binary search tree. With Ranked every node also keeps
+// the size of its subtree, which costs a word per node and an update per
+// ancestor on insert and erase, and makes nth, rank and count_range
+// O(height) instead of a walk from begin().
+//
+// The range constructor, assign and assign_sorted build a perfectly
+// balanced tree in O(n) from sorted input (sorting a copy first if needed),
+// with all its nodes in one allocation.
+//
+// The nodes are also chained in order, and the minimum is cached, so begin()
+// and each step of an iterator are O(1): a scan is one walk along the chain
+// instead of up and down the tree. That costs two pointers per node.
+//
+// set_union, set_intersection, set_difference and set_symmetric_difference
+// (after the class) combine two sets in one in-order walk of both.
+template <class T, bool Ranked = false>
 class set {
  public:
   using key_type = T;
@@ -17,50 +59,96 @@ class set {
   using size_type = std::size_t;
 
  private:
-  struct Node {
+  struct Slab;
+  struct Node : set_node_count<Ranked> {
     value_type data_;
     Node* left_;
     Node* right_;
     Node* parent_;
+    // The block the node was allocated in, or nullptr if it was allocated
+    // on its own.
+    Slab* slab_ = nullptr;
+    // In-order neighbours: the maximum's next_ is end_, whose prev_ is the
+    // maximum, and the minimum's prev_ is nullptr.
+    Node* next_ = nullptr;
+    Node* prev_ = nullptr;
 
     Node() : data_(), left_(nullptr), right_(nullptr), parent_(nullptr) {}
     Node(const value_type& value, Node* parentnode = nullptr)
         : data_(value), left_(nullptr), right_(nullptr), parent_(parentnode) {}
+    Node(value_type&& value)
+        : data_(std::move(value)),
+          left_(nullptr),
+          right_(nullptr),
+          parent_(nullptr) {}
+  };
+  // Nodes allocated together by a bulk build. They are destroyed one by one
+  // like any other node, and the block is freed with the last of them.
+  struct Slab {
+    Node* nodes_;
+    std::size_t capacity_;
+    std::size_t live_;
   };
 
  public:
-  set() : root_(nullptr), end_(nullptr), size_(0) {}
-  ~set() { deleteset(root_); }
+  set() : root_(nullptr), begin_(nullptr), end_(nullptr), size_(0) {}
+  ~set() { deleteset(); }
   set(std::initializer_list<value_type> const& list);
-  set(const set& other) : set() { root_ = copy(other.root_, other.end_); }
+  set(const set& other) : set() { clone(other); }
   set(set&& other);
   set& operator=(set&& other);
   set& operator=(const set& other);
+  template <class InputIt>
+  set(InputIt first, InputIt last) : set() {
+    assign(first, last);
+  }
+
+  // Replace the contents with [first, last). Of equal elements the first
+  // is kept, as with insert. O(n) if the input is already sorted, else
+  // O(n log n) to sort a copy; the version with a pool sorts in parallel on
+  // anything with size() and parallel_for(begin, end, grain, f), such as
+  // thread_pool.
+  template <class InputIt>
+  void assign(InputIt first, InputIt last);
+  template <class RandomIt, class Pool>
+  void assign(RandomIt first, RandomIt last, Pool& pool);
+  // Like assign, for input known to be sorted: no copy, no sort. Throws
+  // std::invalid_argument, leaving the set as it was, if it is not sorted.
+  template <class ForwardIt>
+  void assign_sorted(ForwardIt first, ForwardIt last) {
+    build_from_sorted(first, std::distance(first, last));
+  }
 
   typedef class Iterator {
    public:
     friend class set;
-    Iterator() : set_{nullptr}, current_{nullptr} {}
-    Iterator(Node* iter, const set& obj) : set_{&obj}, current_{iter} {}
-    Iterator(const Iterator& iter) : set_(iter.set_), current_(iter.current_) {}
-    Iterator(Iterator&& iter) : set_(iter.set_), current_(iter.current_) {
-      current_ = nullptr;
-      set_ = nullptr;
+    Iterator() : current_{nullptr} {}
+    Iterator(Node* iter, [[maybe_unused]] const set& obj) : current_{iter} {
+#ifdef MYN_CHECKED_ITERATORS
+      set_ = &obj;
+      generation_ = obj.generation_;
+#endif
     }
+    Iterator(const Iterator& iter) = default;
     ~Iterator() {}
 
-    Iterator& operator=(const Iterator& iter) {
-      current_ = iter.current_;
-      set_ = iter.set_;
-      return *this;
-    }
+    Iterator& operator=(const Iterator& iter) = default;
     bool operator==(const Iterator& iter) const {
       return (current_ == iter.current_);
     }
     bool operator!=(const Iterator& iter) const {
       return (current_ != iter.current_);
     }
-    reference operator*() { return current_->data_; }
+    reference operator*() {
+      if (current_ == nullptr) {
+        throw std::invalid_argument("current_ == nullptr (*iter)");
+      }
+      check_valid();
+#ifdef MYN_CHECKED_ITERATORS
+      check_iterator_range(current_ != set_->end_);
+#endif
+      return current_->data_;
+    }
     value_type* operator->() { return &operator*(); }
     Iterator& operator++();
     Iterator& operator--();
@@ -68,249 +156,734 @@ class set {
     Iterator operator--(int);
 
    private:
-    const set* set_;
     Node* current_;
+#ifdef MYN_CHECKED_ITERATORS
+    const set* set_ = nullptr;
+    std::size_t generation_ = 0;
+#endif
+
+    // Traps on iterators that outlived an erase/clear of their set. Like
+    // list's and vector's, an iterator bound to no set is not checked; the
+    // only such iterator is a default-constructed one, which the callers
+    // reject as null. Empty unless MYN_CHECKED_ITERATORS is set.
+    void check_valid() const {
+#ifdef MYN_CHECKED_ITERATORS
+      if (set_ == nullptr) return;
+      check_iterator_generation(set_->generation_, generation_);
+#endif
+    }
   } iterator;
   typedef const Iterator const_iterator;
-  iterator begin() const { return iterator(getLeftmostNode(root_), *this); }
+
+  // Owns an element taken out of a set by extract, node and all, until
+  // insert(node_type&&) links the same node into a set again. An empty
+  // handle owns nothing.
+  typedef class NodeHandle {
+   public:
+    NodeHandle() noexcept : node_(nullptr) {}
+    NodeHandle(NodeHandle&& other) noexcept
+        : node_(std::exchange(other.node_, nullptr)) {}
+    NodeHandle& operator=(NodeHandle&& other) noexcept {
+      if (this != &other) {
+        reset();
+        node_ = std::exchange(other.node_, nullptr);
+      }
+      return *this;
+    }
+    ~NodeHandle() { reset(); }
+
+    bool empty() const noexcept { return node_ == nullptr; }
+    explicit operator bool() const noexcept { return node_ != nullptr; }
+    // May be changed, key included, while the element is out of any set.
+    reference value() const {
+      if (node_ == nullptr) {
+        throw std::logic_error("node handle is empty");
+      }
+      return node_->data_;
+    }
+
+   private:
+    friend class set;
+    explicit NodeHandle(Node* node) noexcept : node_(node) {}
+    void reset() noexcept {
+      if (node_ != nullptr) destroy_node(node_);
+      node_ = nullptr;
+    }
+
+    Node* node_;
+  } node_type;
+  // What insert(node_type&&) did: the element with the node's key, whether
+  // the node went in, and the node if it did not.
+  struct insert_return_type {
+    iterator position;
+    bool inserted;
+    node_type node;
+  };
+  iterator begin() const { return iterator(begin_, *this); }
   iterator end() const { return iterator(end_, *this); }
   const_iterator cbegin() const { return begin(); }
   const_iterator cend() const { return iterator(end_, *this); }
 
-  size_type size() noexcept { return size_; }
+  size_type size() const noexcept { return size_; }
   size_type max_size() noexcept;
-  bool empty() { return (root_ == nullptr) ? true : false; }
+  bool empty() const noexcept { return (root_ == nullptr) ? true : false; }
   void clear();
   void swap(set& other);
+  // Moves the elements of other whose keys are not in this set over,
+  // relinking their nodes instead of copying them; the others stay behind.
   void merge(set& other);
   iterator find(const key_type& key) const;
   bool contains(const key_type& key) const;
+  // First element not less than key / greater than key, or end().
+  iterator lower_bound(const key_type& key) const {
+    return iterator(lower_bound_node(key), *this);
+  }
+  iterator upper_bound(const key_type& key) const {
+    return iterator(upper_bound_node(key), *this);
+  }
+  std::pair<iterator, iterator> equal_range(const key_type& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  // Calls fn on every element in [lo, hi), in order. One descent finds lo;
+  // the scan stops at the first element not less than hi.
+  template <class F>
+  void for_each_in_range(const key_type& lo, const key_type& hi, F fn);
   void erase(iterator pos);
   std::pair<iterator, bool> insert(const value_type& value) {
     return base_insert(value);
   }
+  // Unlink an element without destroying it. The key overload returns an
+  // empty handle if there is no such element.
+  node_type extract(iterator pos);
+  node_type extract(const key_type& key) {
+    Node* node = search(root_, key);
+    return node == nullptr ? node_type() : node_type(unlink(node));
+  }
+  // Links the handle's node in, allocating nothing unless the set was empty.
+  insert_return_type insert(node_type&& node);
   template <class... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
 
+  // Order statistics; ranked sets only. nth(k) is the element with k
+  // smaller ones, or end() if k >= size(). rank(key) counts the elements
+  // less than key, and count_range(lo, hi) those in [lo, hi).
+  iterator nth(size_type k) const;
+  size_type rank(const key_type& key) const;
+  size_type count_range(const key_type& lo, const key_type& hi) const {
+    size_type below_hi = rank(hi);
+    size_type below_lo = rank(lo);
+    return below_hi > below_lo ? below_hi - below_lo : 0;
+  }
+
  private:
   Node* root_;
+  Node* begin_;
   Node* end_;
   std::size_t size_;
-  std::allocator<typename set<T>::Node> allocator_;
-  using BaseKeyType = typename std::decay<key_type>::type;
-  BaseKeyType key_max_{};
+  std::allocator<Node> allocator_;
+
+#ifdef MYN_CHECKED_ITERATORS
+  std::size_t generation_ = 0;
+#endif
 
-  void deleteset(Node*& node);
+  Node* create_node(const value_type& value);
+  Node* create_end();
+  static void destroy_node(Node* node) noexcept;
+  Slab* create_slab(size_type capacity);
+  void discard_slab(Slab* slab) noexcept;
+  template <class ForwardIt>
+  void build_from_sorted(ForwardIt first, size_type n);
+  template <class RandomIt>
+  void sort_buffer(RandomIt first, RandomIt last);
+  template <class RandomIt, class Pool>
+  void sort_buffer(RandomIt first, RandomIt last, Pool& pool);
+  static Node* link_balanced(Node* nodes, size_type lo, size_type hi,
+                             Node* parent) noexcept;
+  void deleteset() noexcept;
   void transplant(Node* old, Node* fresh);
-  Node* copy(Node* node, Node* end);
-  Node* search(Node* node, const key_type key) const;
-  Node* getLeftmostNode(Node* node) const;
-  Node* getRightmostNode(Node* node) const;
+  void clone(const set& other);
+  void thread_in_order() noexcept;
+  Node* search(Node* node, const key_type& key) const;
+  Node* lower_bound_node(const key_type& key) const;
+  Node* upper_bound_node(const key_type& key) const;
+  static Node* getLeftmostNode(Node* node);
+  static Node* next_node(Node* node);
+  std::pair<iterator, bool> link(Node* node);
+  Node* descend(const key_type& key, Node*& parent) const;
+  void attach(Node* node, Node* parent);
+  Node* unlink(Node* node);
+  static size_type subtree_count(const Node* node) noexcept {
+    if constexpr (Ranked) {
+      return node == nullptr ? 0 : node->count_;
+    } else {
+      return 0;
+    }
+  }
+  // Adds one to (or takes one from) the counts of node and its ancestors.
+  static void update_counts(Node* node, bool grow) noexcept {
+    if constexpr (Ranked) {
+      for (; node != nullptr; node = node->parent_) {
+        node->count_ = grow ? node->count_ + 1 : node->count_ - 1;
+      }
+    }
+  }
+  void invalidate_iterators() noexcept {
+#ifdef MYN_CHECKED_ITERATORS
+    ++generation_;
+#endif
+  }
 
  protected:
+  template <class U, bool R, class OutputIt>
+  friend OutputIt set_combine(const set<U, R>& a, const set<U, R>& b,
+                              set_operation op, OutputIt out);
+  Node* lower_bound_from(Node* finger, const key_type& key) const;
+
   std::pair<iterator, bool> base_insert(const value_type& value,
                                         bool insert = false);
-  bool assign_value(typename set<T>::Node* current, const value_type& value,
-                    bool insert);
+  bool assign_value(Node* current, const value_type& value, bool insert);
   virtual bool comp_key_less(const key_type& first,
                              const key_type& second) const;
   bool comp_key_eq(const key_type& first, const key_type& second) const;
 };
 
-template <class T>
-set<T>::set(std::initializer_list<T> const& list) : set() {
+template <class T, bool Ranked>
+set<T, Ranked>::set(std::initializer_list<T> const& list) : set() {
   for (const auto& item : list) {
     insert(item);
   }
 }
-template <class T>
-set<T>::set(set&& other)
-    : root_(std::move(other.root_)), end_(other.end_), size_(other.size_) {
+template <class T, bool Ranked>
+set<T, Ranked>::set(set&& other)
+    : root_(other.root_),
+      begin_(other.begin_),
+      end_(other.end_),
+      size_(other.size_) {
   other.root_ = nullptr;
+  other.begin_ = nullptr;
   other.size_ = 0;
   other.end_ = nullptr;
 }
-template <class T>
-set<T>& set<T>::operator=(set&& other) {
+template <class T, bool Ranked>
+set<T, Ranked>& set<T, Ranked>::operator=(set&& other) {
   if (this != &other) {
     clear();
+    other.invalidate_iterators();
     root_ = other.root_;
+    begin_ = other.begin_;
     size_ = other.size_;
     end_ = other.end_;
     other.root_ = nullptr;
+    other.begin_ = nullptr;
     other.size_ = 0;
     other.end_ = nullptr;
   }
   return *this;
 }
-template <class T>
-set<T>& set<T>::operator=(const set& other) {
-  if (this != &other) {
-    root_ = copy(other.root_, other.end_);
-  }
+template <class T, bool Ranked>
+set<T, Ranked>& set<T, Ranked>::operator=(const set& other) {
+  if (this != &other) clone(other);
   return *this;
 }
 
-template <class T>
-typename set<T>::Iterator& set<T>::Iterator::operator++() {
+template <class T, bool Ranked>
+typename set<T, Ranked>::Iterator& set<T, Ranked>::Iterator::operator++() {
   if (current_ == nullptr) {
     throw std::invalid_argument("current_ == nullptr (++iter)");
   }
-  if (current_->right_ != nullptr) {
-    current_ = set_->getLeftmostNode(current_->right_);
-  } else {
-    Node* this_iter = nullptr;
-    do {
-      this_iter = current_;
-      current_ = current_->parent_;
-    } while (current_->parent_ && current_->right_ == this_iter);
-  }
+  check_valid();
+#ifdef MYN_CHECKED_ITERATORS
+  check_iterator_range(current_ != set_->end_);
+#endif
+  current_ = current_->next_;
   return *this;
 }
-template <class T>
-typename set<T>::Iterator set<T>::Iterator::operator++(int) {
+template <class T, bool Ranked>
+typename set<T, Ranked>::Iterator set<T, Ranked>::Iterator::operator++(int) {
   Iterator tmp = *this;
   ++(*this);
   return tmp;
 }
-template <class T>
-typename set<T>::Iterator& set<T>::Iterator::operator--() {
+template <class T, bool Ranked>
+typename set<T, Ranked>::Iterator& set<T, Ranked>::Iterator::operator--() {
   if (current_ == nullptr) {
     throw std::invalid_argument("current_ == nullptr (--iter)");
   }
-  if (current_->left_ != nullptr) {
-    current_ = set_->getRightmostNode(current_->left_);
-  } else {
-    Node* this_iter = nullptr;
-    do {
-      this_iter = current_;
-      current_ = current_->parent_;
-    } while (current_->parent_ && current_->left_ == this_iter);
-  }
+  check_valid();
+#ifdef MYN_CHECKED_ITERATORS
+  check_iterator_range(current_ != set_->begin_);
+#endif
+  current_ = current_->prev_;
   return *this;
 }
-template <class T>
-typename set<T>::Iterator set<T>::Iterator::operator--(int) {
+template <class T, bool Ranked>
+typename set<T, Ranked>::Iterator set<T, Ranked>::Iterator::operator--(int) {
   Iterator tmp = *this;
   --(*this);
   return tmp;
 }
 
-template <class T>
-typename set<T>::size_type set<T>::max_size() noexcept {
-  return std::allocator_traits<std::allocator<typename set<T>::Node>>::max_size(
-      allocator_);
+template <class T, bool Ranked>
+typename set<T, Ranked>::size_type set<T, Ranked>::max_size() noexcept {
+  return std::allocator_traits<std::allocator<Node>>::max_size(allocator_);
 }
-template <class T>
-void set<T>::clear() {
-  deleteset(root_);
+template <class T, bool Ranked>
+void set<T, Ranked>::clear() {
+  deleteset();
+  begin_ = nullptr;
+  end_ = nullptr;
   size_ = 0;
+  invalidate_iterators();
 }
-template <class T>
-void set<T>::swap(set& other) {
+template <class T, bool Ranked>
+void set<T, Ranked>::swap(set& other) {
   if (root_ != other.root_) {
     std::swap(root_, other.root_);
+    std::swap(begin_, other.begin_);
     std::swap(size_, other.size_);
     std::swap(end_, other.end_);
   }
 }
-template <class T>
-void set<T>::merge(set& other) {
-  if (root_ != other.root_) {
-    for (const auto& value : other) {
-      insert(value);
+template <class T, bool Ranked>
+void set<T, Ranked>::merge(set& other) {
+  if (this == &other || other.root_ == nullptr) return;
+  if (root_ == nullptr) {
+    swap(other);
+    return;
+  }
+  Node* node = other.begin_;
+  while (node != nullptr) {
+    Node* next = next_node(node);
+    if (next == other.end_) next = nullptr;
+    Node* parent = nullptr;
+    if (descend(node->data_, parent) == nullptr) {
+      attach(other.unlink(node), parent);
+    }
+    node = next;
+  }
+}
+template <class T, bool Ranked>
+template <class InputIt>
+void set<T, Ranked>::assign(InputIt first, InputIt last) {
+  vector<value_type> buffer;
+  for (; first != last; ++first) buffer.push_back(*first);
+  sort_buffer(buffer.data(), buffer.data() + buffer.size());
+  build_from_sorted(std::make_move_iterator(buffer.data()), buffer.size());
+}
+
+template <class T, bool Ranked>
+template <class RandomIt, class Pool>
+void set<T, Ranked>::assign(RandomIt first, RandomIt last, Pool& pool) {
+  vector<value_type> buffer;
+  buffer.reserve(last - first);
+  for (; first != last; ++first) buffer.push_back(*first);
+  sort_buffer(buffer.data(), buffer.data() + buffer.size(), pool);
+  build_from_sorted(std::make_move_iterator(buffer.data()), buffer.size());
+}
+
+// Stable, so that of equal elements the first stays first and survives the
+// build.
+template <class T, bool Ranked>
+template <class RandomIt>
+void set<T, Ranked>::sort_buffer(RandomIt first, RandomIt last) {
+  auto less = [this](const value_type& a, const value_type& b) {
+    return comp_key_less(a, b);
+  };
+  if (!std::is_sorted(first, last, less)) std::stable_sort(first, last, less);
+}
+
+// In parallel: sort pool-sized chunks, then merge neighbouring runs in rounds
+// of doubling width.
+template <class T, bool Ranked>
+template <class RandomIt, class Pool>
+void set<T, Ranked>::sort_buffer(RandomIt first, RandomIt last, Pool& pool) {
+  auto less = [this](const value_type& a, const value_type& b) {
+    return comp_key_less(a, b);
+  };
+  if (std::is_sorted(first, last, less)) return;
+  const size_type n = last - first;
+  const size_type chunks = 4 * static_cast<size_type>(pool.size());
+  if (chunks < 2 || n < 2 * chunks) {
+    std::stable_sort(first, last, less);
+    return;
+  }
+  const size_type width = (n + chunks - 1) / chunks;
+  pool.parallel_for(size_type(0), chunks, size_type(1),
+                    [&](size_type lo, size_type hi) {
+                      for (size_type c = lo; c < hi; ++c) {
+                        std::stable_sort(first + std::min(n, c * width),
+                                         first + std::min(n, (c + 1) * width),
+                                         less);
+                      }
+                    });
+  for (size_type run = width; run < n; run *= 2) {
+    size_type pairs = (n + 2 * run - 1) / (2 * run);
+    pool.parallel_for(size_type(0), pairs, size_type(1),
+                      [&](size_type lo, size_type hi) {
+                        for (size_type p = lo; p < hi; ++p) {
+                          size_type begin = p * 2 * run;
+                          size_type middle = std::min(n, begin + run);
+                          size_type end = std::min(n, begin + 2 * run);
+                          std::inplace_merge(first + begin, first + middle,
+                                             first + end, less);
+                        }
+                      });
+  }
+}
+
+// Constructs the nodes in order in one slab, dropping each that equals its
+// predecessor, then links them as a balanced tree. Nothing changes until
+// every node is built.
+template <class T, bool Ranked>
+template <class ForwardIt>
+void set<T, Ranked>::build_from_sorted(ForwardIt first, size_type n) {
+  if (n == 0) {
+    clear();
+    return;
+  }
+  Slab* slab = create_slab(n);
+  Node* end = nullptr;
+  try {
+    for (size_type i = 0; i < n; ++i, ++first) {
+      Node* node = slab->nodes_ + slab->live_;
+      allocator_.construct(node, *first);
+      node->slab_ = slab;
+      ++slab->live_;
+      if (slab->live_ == 1) continue;
+      const value_type& previous = node[-1].data_;
+      if (comp_key_less(node->data_, previous)) {
+        throw std::invalid_argument("input is not sorted (assign_sorted)");
+      }
+      if (!comp_key_less(previous, node->data_)) {
+        allocator_.destroy(node);
+        --slab->live_;
+      }
     }
+    end = create_end();
+  } catch (...) {
+    discard_slab(slab);
+    throw;
   }
+  clear();
+  size_ = slab->live_;
+  root_ = link_balanced(slab->nodes_, 0, size_, nullptr);
+  end_ = end;
+  end_->parent_ = slab->nodes_ + size_ - 1;
+  end_->parent_->right_ = end_;
+  // The slab is already in order.
+  begin_ = slab->nodes_;
+  for (size_type i = 0; i < size_; ++i) {
+    slab->nodes_[i].prev_ = i == 0 ? nullptr : slab->nodes_ + i - 1;
+    slab->nodes_[i].next_ = i + 1 == size_ ? end_ : slab->nodes_ + i + 1;
+  }
+  end_->prev_ = slab->nodes_ + size_ - 1;
+}
+
+// Makes nodes[(lo + hi) / 2] the root of [lo, hi) and recurses into both
+// halves; the depth is log2 of the node count.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::link_balanced(
+    Node* nodes, size_type lo, size_type hi, Node* parent) noexcept {
+  if (lo == hi) return nullptr;
+  size_type mid = lo + (hi - lo) / 2;
+  Node* node = nodes + mid;
+  node->parent_ = parent;
+  node->left_ = link_balanced(nodes, lo, mid, node);
+  node->right_ = link_balanced(nodes, mid + 1, hi, node);
+  if constexpr (Ranked) node->count_ = hi - lo;
+  return node;
 }
-template <class T>
-typename set<T>::Node* set<T>::copy(typename set<T>::Node* node,
-                                    typename set<T>::Node* end) {
-  if (node == nullptr || node == end) {
-    return end_;
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::create_node(
+    const value_type& value) {
+  Node* node = allocator_.allocate(1);
+  try {
+    allocator_.construct(node, value, nullptr);
+  } catch (...) {
+    allocator_.deallocate(node, 1);
+    throw;
   }
-  std::pair<iterator, bool> my_pair = insert(node->data_);
-  Node* newNode = my_pair.first.current_;
+  return node;
+}
 
-  if (node->left_ != nullptr) {
-    newNode->left_ = copy(node->left_, end);
+// end_ holds a default-constructed value that is never compared, and counts
+// for nothing in a ranked set.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::create_end() {
+  Node* node = allocator_.allocate(1);
+  try {
+    allocator_.construct(node);
+  } catch (...) {
+    allocator_.deallocate(node, 1);
+    throw;
   }
-  if (node->right_ != nullptr) {
-    newNode->right_ = copy(node->right_, end);
+  if constexpr (Ranked) node->count_ = 0;
+  return node;
+}
+
+// Static, for node handles that outlive their set; std::allocator has no
+// state to share.
+template <class T, bool Ranked>
+void set<T, Ranked>::destroy_node(Node* node) noexcept {
+  std::allocator<Node> allocator;
+  Slab* slab = node->slab_;
+  allocator.destroy(node);
+  if (slab == nullptr) {
+    allocator.deallocate(node, 1);
+  } else if (--slab->live_ == 0) {
+    allocator.deallocate(slab->nodes_, slab->capacity_);
+    delete slab;
+  }
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::Slab* set<T, Ranked>::create_slab(
+    size_type capacity) {
+  Slab* slab = new Slab{nullptr, capacity, 0};
+  try {
+    slab->nodes_ = allocator_.allocate(capacity);
+  } catch (...) {
+    delete slab;
+    throw;
   }
-  return newNode;
+  return slab;
 }
-template <class T>
-typename set<T>::iterator set<T>::find(const key_type& key) const {
+
+// For a slab whose nodes, constructed in order from the first, were never
+// handed out: destroys them and frees the block.
+template <class T, bool Ranked>
+void set<T, Ranked>::discard_slab(Slab* slab) noexcept {
+  for (size_type i = 0; i < slab->live_; ++i) {
+    allocator_.destroy(slab->nodes_ + i);
+  }
+  allocator_.deallocate(slab->nodes_, slab->capacity_);
+  delete slab;
+}
+
+// Replaces the contents with a copy of other's tree, shape and all: a
+// preorder walk along parent pointers that copies each node into the next
+// slot of one slab and links it under the copy of its parent. No key is
+// compared, and no stack is needed however deep the tree is. Nothing
+// changes until every node is built.
+template <class T, bool Ranked>
+void set<T, Ranked>::clone(const set& other) {
+  if (other.root_ == nullptr) {
+    clear();
+    return;
+  }
+  Slab* slab = create_slab(other.size_);
+  Node* end = nullptr;
+  auto copy_node = [this, slab](const Node* source, Node* parent) {
+    Node* node = slab->nodes_ + slab->live_;
+    allocator_.construct(node, source->data_, parent);
+    node->slab_ = slab;
+    if constexpr (Ranked) node->count_ = source->count_;
+    ++slab->live_;
+    return node;
+  };
+  Node* root = nullptr;
+  try {
+    root = copy_node(other.root_, nullptr);
+    end = create_end();
+  } catch (...) {
+    discard_slab(slab);
+    throw;
+  }
+  try {
+    const Node* source = other.root_;
+    Node* target = root;
+    while (target != nullptr) {
+      if (source->left_ != nullptr) {
+        target->left_ = copy_node(source->left_, target);
+        source = source->left_;
+        target = target->left_;
+      } else if (source->right_ != nullptr && source->right_ != other.end_) {
+        target->right_ = copy_node(source->right_, target);
+        source = source->right_;
+        target = target->right_;
+      } else {
+        // Up to the nearest ancestor entered from the left that has a right
+        // subtree still to copy.
+        if (source->right_ == other.end_) {
+          target->right_ = end;
+          end->parent_ = target;
+        }
+        while (true) {
+          const Node* child = source;
+          source = source->parent_;
+          target = target->parent_;
+          if (source == nullptr) break;
+          if (child == source->left_ && source->right_ != nullptr &&
+              source->right_ != other.end_) {
+            target->right_ = copy_node(source->right_, target);
+            source = source->right_;
+            target = target->right_;
+            break;
+          }
+          if (child == source->left_ && source->right_ == other.end_) {
+            target->right_ = end;
+            end->parent_ = target;
+          }
+        }
+      }
+    }
+  } catch (...) {
+    destroy_node(end);
+    discard_slab(slab);
+    throw;
+  }
+  clear();
+  root_ = root;
+  end_ = end;
+  size_ = other.size_;
+  thread_in_order();
+}
+
+// Chains the nodes in order and finds begin_, for a tree linked without
+// them. Walks the tree once along parent pointers, O(n) in all.
+template <class T, bool Ranked>
+void set<T, Ranked>::thread_in_order() noexcept {
+  begin_ = getLeftmostNode(root_);
+  Node* previous = nullptr;
+  Node* node = begin_;
+  while (node != end_) {
+    node->prev_ = previous;
+    if (previous != nullptr) previous->next_ = node;
+    previous = node;
+    if (node->right_ != nullptr) {
+      node = getLeftmostNode(node->right_);
+    } else {
+      while (node->parent_->right_ == node) node = node->parent_;
+      node = node->parent_;
+    }
+  }
+  previous->next_ = end_;
+  end_->prev_ = previous;
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::iterator set<T, Ranked>::find(
+    const key_type& key) const {
   iterator iter(search(root_, key), *this);
   return iter;
 }
-template <class T>
-bool set<T>::contains(const key_type& key) const {
+template <class T, bool Ranked>
+bool set<T, Ranked>::contains(const key_type& key) const {
   return (search(root_, key) == nullptr) ? false : true;
 }
 
-template <class T>
-std::pair<typename set<T>::iterator, bool> set<T>::base_insert(const T& value,
-                                                               bool insert) {
+template <class T, bool Ranked>
+std::pair<typename set<T, Ranked>::iterator, bool>
+set<T, Ranked>::base_insert(const T& value, bool insert) {
+  Node* new_node = create_node(value);
   std::pair<iterator, bool> return_pair;
-  Node* new_node = allocator_.allocate(1);
-  allocator_.construct(new_node, value, nullptr);
-  return_pair.first.current_ = new_node;
-  return_pair.second = true;
-  ++size_;
+  try {
+    return_pair = link(new_node);
+  } catch (...) {
+    destroy_node(new_node);
+    throw;
+  }
+  if (!return_pair.second) {
+    return_pair.second =
+        assign_value(return_pair.first.current_, value, insert);
+    destroy_node(new_node);
+  }
+  return return_pair;
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::insert_return_type set<T, Ranked>::insert(
+    node_type&& node) {
+  if (node.empty()) return {end(), false, node_type()};
+  std::pair<iterator, bool> linked = link(node.node_);
+  if (linked.second) node.node_ = nullptr;
+  return {linked.first, linked.second, std::move(node)};
+}
+
+// Hangs a detached node (fresh, or cleared by unlink) where its key
+// belongs, or returns the element with an equal key and false, leaving the
+// node detached.
+template <class T, bool Ranked>
+std::pair<typename set<T, Ranked>::iterator, bool> set<T, Ranked>::link(
+    Node* new_node) {
   if (root_ == nullptr) {
+    end_ = create_end();
     root_ = new_node;
-    end_ = allocator_.allocate(1);
-    allocator_.construct(end_);
     root_->right_ = end_;
     end_->parent_ = root_;
-  } else {
-    Node* current = root_;
-    Node* parent = nullptr;
-    while (current != nullptr && current != end_) {
-      parent = current;
-      if (comp_key_less(value, current->data_)) {
-        current = current->left_;
-      } else if (!comp_key_less(value, current->data_) &&
-                 !comp_key_eq(value, current->data_)) {
-        current = current->right_;
-      } else {
-        return_pair.first = iterator(current, *this);
-        return_pair.second = assign_value(current, value, insert);
-        allocator_.destroy(new_node);
-        allocator_.deallocate(new_node, 1);
-        --size_;
-        return return_pair;
-      }
-    }
-    if (comp_key_less(key_max_, value))
-      key_max_ = static_cast<BaseKeyType>(value);
-    new_node->parent_ = parent;
-    if (comp_key_less(value, parent->data_)) {
-      parent->left_ = new_node;
-      new_node->parent_ = parent;
+    begin_ = new_node;
+    new_node->next_ = end_;
+    end_->prev_ = new_node;
+    ++size_;
+    return {iterator(new_node, *this), true};
+  }
+  Node* parent = nullptr;
+  Node* equal = descend(new_node->data_, parent);
+  if (equal != nullptr) return {iterator(equal, *this), false};
+  attach(new_node, parent);
+  return {iterator(new_node, *this), true};
+}
+
+// Returns the node with a key equal to key, or nullptr after setting parent
+// to the node that key would hang under. The set must not be empty.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::descend(const key_type& key,
+                                                       Node*& parent) const {
+  Node* current = root_;
+  while (current != nullptr && current != end_) {
+    parent = current;
+    if (comp_key_less(key, current->data_)) {
+      current = current->left_;
+    } else if (comp_key_less(current->data_, key)) {
+      current = current->right_;
     } else {
-      new_node->right_ = parent->right_;  // move end_
-      parent->right_ = new_node;          // insert node
-      new_node->parent_ = parent;         // insert parent
-      if (comp_key_eq(key_max_, value)) {
-        end_->parent_ = new_node;
-      }  // update parent on end_
+      return current;
     }
   }
-  return return_pair;
+  return nullptr;
 }
 
-template <class T>
+template <class T, bool Ranked>
+void set<T, Ranked>::attach(Node* new_node, Node* parent) {
+  new_node->parent_ = parent;
+  // A left child comes just before its parent, a right child just after.
+  Node* next;
+  if (comp_key_less(new_node->data_, parent->data_)) {
+    parent->left_ = new_node;
+    next = parent;
+  } else {
+    next = parent->next_;
+    // Only the maximum has end_ on its right, and the new node takes over
+    // from it.
+    if (parent->right_ == end_) {
+      new_node->right_ = end_;
+      end_->parent_ = new_node;
+    }
+    parent->right_ = new_node;
+  }
+  new_node->next_ = next;
+  new_node->prev_ = next->prev_;
+  next->prev_ = new_node;
+  if (new_node->prev_ != nullptr) {
+    new_node->prev_->next_ = new_node;
+  } else {
+    begin_ = new_node;
+  }
+  ++size_;
+  update_counts(parent, true);
+}
+
+template <class T, bool Ranked>
 template <class... Args>
-std::vector<std::pair<typename set<T>::iterator, bool>> set<T>::insert_many(
-    Args&&... args) {
+std::vector<std::pair<typename set<T, Ranked>::iterator, bool>>
+set<T, Ranked>::insert_many(Args&&... args) {
   return {insert(std::forward<Args>(args))...};
 }
 
-template <class T>
-bool set<T>::assign_value(typename set<T>::Node* current, const T& value,
-                          bool insert) {
+template <class T, bool Ranked>
+bool set<T, Ranked>::assign_value(Node* current, const T& value,
+                                  bool insert) {
   bool res_insert = false;
   if (insert == true) {
     current->data_ = value;
@@ -319,49 +892,210 @@ bool set<T>::assign_value(typename set<T>::Node* current, const T& value,
   return res_insert;
 }
 
-template <class T>
-bool set<T>::comp_key_less(const key_type& first,
-                           const key_type& second) const {
+template <class T, bool Ranked>
+bool set<T, Ranked>::comp_key_less(const key_type& first,
+                                   const key_type& second) const {
   return (first < second) ? true : false;
 }
 
-template <class T>
-bool set<T>::comp_key_eq(const key_type& first, const key_type& second) const {
+template <class T, bool Ranked>
+bool set<T, Ranked>::comp_key_eq(const key_type& first,
+                                 const key_type& second) const {
   return (!comp_key_less(first, second) && !comp_key_less(second, first))
              ? true
              : false;
 }
 
-template <class T>
-void set<T>::erase(typename set<T>::iterator pos) {
+template <class T, bool Ranked>
+void set<T, Ranked>::erase(iterator pos) {
   if (pos == end() || pos.current_ == nullptr) {
     throw std::invalid_argument("iter == nullptr (erase)");
   }
-  Node* node_to_rm = pos.current_;
+  pos.check_valid();
+  destroy_node(unlink(pos.current_));
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::node_type set<T, Ranked>::extract(iterator pos) {
+  if (pos == end() || pos.current_ == nullptr) {
+    throw std::invalid_argument("iter == nullptr (extract)");
+  }
+  pos.check_valid();
+  return node_type(unlink(pos.current_));
+}
+
+// Takes node out of the tree and returns it detached: no links, and a
+// subtree count of one. Other nodes keep their addresses: when node has two
+// children its successor is moved into its place, not copied.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::unlink(Node* node_to_rm) {
+  // Unhook end_ from the maximum while it is removed and hang it under the
+  // new maximum afterwards.
+  bool was_max = node_to_rm->right_ == end_;
+  if (was_max) node_to_rm->right_ = nullptr;
+  // The node that leaves its place is node_to_rm, or its successor when
+  // that moves up to replace it.
+  bool two_children =
+      node_to_rm->left_ != nullptr && node_to_rm->right_ != nullptr;
+  update_counts(two_children ? node_to_rm->next_->parent_
+                             : node_to_rm->parent_,
+                false);
+  Node* previous = node_to_rm->prev_;
+  node_to_rm->next_->prev_ = previous;
+  if (previous != nullptr) {
+    previous->next_ = node_to_rm->next_;
+  } else {
+    begin_ = node_to_rm->next_;
+  }
 
   if (node_to_rm->left_ == nullptr) {
     transplant(node_to_rm, node_to_rm->right_);
   } else if (node_to_rm->right_ == nullptr) {
     transplant(node_to_rm, node_to_rm->left_);
   } else {
-    iterator min_right(getLeftmostNode(node_to_rm->right_), *this);
-    if (min_right.current_->parent_ != node_to_rm) {
-      transplant(min_right.current_, min_right.current_->right_);
-      min_right.current_->right_ = node_to_rm->right_;
-      min_right.current_->right_->parent_ = min_right.current_;
+    Node* min_right = node_to_rm->next_;
+    if (min_right->parent_ != node_to_rm) {
+      transplant(min_right, min_right->right_);
+      min_right->right_ = node_to_rm->right_;
+      min_right->right_->parent_ = min_right;
     }
-    transplant(node_to_rm, min_right.current_);
-    min_right.current_->left_ = node_to_rm->left_;
-    min_right.current_->left_->parent_ = min_right.current_;
+    transplant(node_to_rm, min_right);
+    min_right->left_ = node_to_rm->left_;
+    min_right->left_->parent_ = min_right;
+    if constexpr (Ranked) min_right->count_ = node_to_rm->count_;
   }
-  allocator_.destroy(node_to_rm);
-  allocator_.deallocate(node_to_rm, 1);
+  node_to_rm->left_ = nullptr;
+  node_to_rm->right_ = nullptr;
+  node_to_rm->parent_ = nullptr;
+  node_to_rm->next_ = nullptr;
+  node_to_rm->prev_ = nullptr;
+  if constexpr (Ranked) node_to_rm->count_ = 1;
   --size_;
+  if (root_ == nullptr) {
+    destroy_node(end_);
+    begin_ = nullptr;
+    end_ = nullptr;
+  } else if (was_max) {
+    previous->right_ = end_;
+    end_->parent_ = previous;
+  }
+  invalidate_iterators();
+  return node_to_rm;
+}
+
+template <class T, bool Ranked>
+template <class F>
+void set<T, Ranked>::for_each_in_range(const key_type& lo, const key_type& hi,
+                                       F fn) {
+  for (iterator it = lower_bound(lo); it.current_ != end_; ++it) {
+    if (!comp_key_less(*it, hi)) break;
+    fn(*it);
+  }
+}
+
+// end_ stands for "greater than everything", so both descents stop at it
+// and start from it as the answer.
+// lower_bound_node(key) for a key greater than every element before finger,
+// finger being a lower bound of an earlier key: climbs only as high as the
+// subtree that must hold the answer and descends from there. In a balanced
+// tree skipping d elements costs O(log d) instead of a descent from the
+// root. A null finger means no earlier key.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::lower_bound_from(
+    Node* finger, const key_type& key) const {
+  if (finger == nullptr) return lower_bound_node(key);
+  if (finger == end_) return end_;
+  Node* bound = end_;
+  Node* node = finger;
+  // Parents on the left of node are less than finger, so less than key.
+  while (node->parent_ != nullptr) {
+    Node* parent = node->parent_;
+    if (parent->left_ == node && !comp_key_less(parent->data_, key)) {
+      bound = parent;
+      break;
+    }
+    node = parent;
+  }
+  while (node != nullptr && node != end_) {
+    if (comp_key_less(node->data_, key)) {
+      node = node->right_;
+    } else {
+      bound = node;
+      node = node->left_;
+    }
+  }
+  return bound;
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::lower_bound_node(
+    const key_type& key) const {
+  Node* result = end_;
+  Node* node = root_;
+  while (node != nullptr && node != end_) {
+    if (comp_key_less(node->data_, key)) {
+      node = node->right_;
+    } else {
+      result = node;
+      node = node->left_;
+    }
+  }
+  return result;
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::upper_bound_node(
+    const key_type& key) const {
+  Node* result = end_;
+  Node* node = root_;
+  while (node != nullptr && node != end_) {
+    if (comp_key_less(key, node->data_)) {
+      result = node;
+      node = node->left_;
+    } else {
+      node = node->right_;
+    }
+  }
+  return result;
 }
 
-template <class T>
-void set<T>::transplant(typename set<T>::Node* old,
-                        typename set<T>::Node* fresh) {
+template <class T, bool Ranked>
+typename set<T, Ranked>::iterator set<T, Ranked>::nth(size_type k) const {
+  static_assert(Ranked, "nth needs a ranked set");
+  if (k >= size_) return end();
+  Node* node = root_;
+  while (true) {
+    size_type left = subtree_count(node->left_);
+    if (k < left) {
+      node = node->left_;
+    } else if (k == left) {
+      return iterator(node, *this);
+    } else {
+      k -= left + 1;
+      node = node->right_;
+    }
+  }
+}
+
+template <class T, bool Ranked>
+typename set<T, Ranked>::size_type set<T, Ranked>::rank(
+    const key_type& key) const {
+  static_assert(Ranked, "rank needs a ranked set");
+  size_type below = 0;
+  Node* node = root_;
+  while (node != nullptr && node != end_) {
+    if (comp_key_less(node->data_, key)) {
+      below += subtree_count(node->left_) + 1;
+      node = node->right_;
+    } else {
+      node = node->left_;
+    }
+  }
+  return below;
+}
+
+template <class T, bool Ranked>
+void set<T, Ranked>::transplant(Node* old, Node* fresh) {
   if (old->parent_ == nullptr) {
     root_ = fresh;
   } else if (old == old->parent_->left_) {
@@ -374,46 +1108,169 @@ void set<T>::transplant(typename set<T>::Node* old,
   }
 }
 
-template <class T>
-typename set<T>::Node* set<T>::getLeftmostNode(Node* node) const {
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::getLeftmostNode(Node* node) {
   while (node != nullptr && node->left_ != nullptr) {
     node = node->left_;
   }
   return node;
 }
-template <class T>
-typename set<T>::Node* set<T>::getRightmostNode(Node* node) const {
-  while (node != nullptr && node->right_ != nullptr) {
-    node = node->right_;
+// In-order successor; end_ follows the maximum.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::next_node(Node* node) {
+  return node->next_;
+}
+// Loops rather than recurses, so a degenerate tree costs time but not
+// stack.
+template <class T, bool Ranked>
+typename set<T, Ranked>::Node* set<T, Ranked>::search(
+    Node* node, const key_type& key) const {
+  while (node != nullptr && node != end_) {
+    if (comp_key_less(key, node->data_)) {
+      node = node->left_;
+    } else if (comp_key_less(node->data_, key)) {
+      node = node->right_;
+    } else {
+      return node;
+    }
   }
-  return node;
+  return nullptr;
 }
-template <class T>
-typename set<T>::Node* set<T>::search(typename set<T>::Node* node,
-                                      const key_type key) const {
-  if (node == nullptr) return nullptr;
-  if (comp_key_eq(node->data_, key)) return node;
 
-  return (comp_key_less(key, node->data_)) ? search(node->left_, key)
-                                           : search(node->right_, key);
+// Frees the nodes along the in-order chain, end_ last, without touching the
+// tree links: O(n) time and no stack whatever the shape.
+template <class T, bool Ranked>
+void set<T, Ranked>::deleteset() noexcept {
+  Node* node = begin_;
+  while (node != nullptr) {
+    Node* next = node->next_;
+    destroy_node(node);
+    node = next;
+  }
+  root_ = nullptr;
 }
 
-template <class T>
-void set<T>::deleteset(typename set<T>::Node*& node) {
-  if (node == nullptr) {
-    return;
+// Writes the result of op on a and b to out in order, as the std algorithms
+// of the same names do for sorted ranges: in one walk of both sets, O(n + m)
+// with no descents. Elements of a take precedence over equal ones of b.
+//
+// When only matches in b matter (intersection, difference) and b is much
+// the larger set, the walk covers a alone and finds each match by a finger
+// search from the previous one, in O(n log(m / n)); likewise with the roles
+// swapped for an intersection with a much larger a.
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_combine(const set<T, Ranked>& a, const set<T, Ranked>& b,
+                     set_operation op, OutputIt out) {
+  using Set = set<T, Ranked>;
+  using Node = typename Set::Node;
+  const bool keep_a_only = op != set_operation::kIntersection;
+  const bool keep_b_only = op == set_operation::kUnion ||
+                           op == set_operation::kSymmetricDifference;
+  const bool keep_both =
+      op == set_operation::kUnion || op == set_operation::kIntersection;
+  auto first = [](const Set& s) {
+    return s.begin_;
+  };
+  auto done = [](const Set& s, const Node* node) {
+    return node == nullptr || node == s.end_;
+  };
+  // Skewed enough that finger searches beat stepping through every node.
+  auto skewed = [](std::size_t small, std::size_t large) {
+    return small < large / 16;
+  };
+
+  if (!keep_b_only && skewed(a.size_, b.size_)) {
+    Node* y = nullptr;
+    for (Node* x = first(a); !done(a, x); x = Set::next_node(x)) {
+      y = b.lower_bound_from(y, x->data_);
+      bool match = !done(b, y) && !a.comp_key_less(x->data_, y->data_);
+      if (match ? keep_both : keep_a_only) *out++ = x->data_;
+    }
+    return out;
   }
-  if (node->left_ != nullptr) {
-    deleteset(node->left_);
+  if (op == set_operation::kIntersection && skewed(b.size_, a.size_)) {
+    Node* x = nullptr;
+    for (Node* y = first(b); !done(b, y); y = Set::next_node(y)) {
+      x = a.lower_bound_from(x, y->data_);
+      if (!done(a, x) && !a.comp_key_less(y->data_, x->data_)) {
+        *out++ = x->data_;
+      }
+    }
+    return out;
   }
-  if (node->right_ != nullptr) {
-    deleteset(node->right_);
+
+  Node* x = first(a);
+  Node* y = first(b);
+  while (!done(a, x) && !done(b, y)) {
+    if (a.comp_key_less(x->data_, y->data_)) {
+      if (keep_a_only) *out++ = x->data_;
+      x = Set::next_node(x);
+    } else if (a.comp_key_less(y->data_, x->data_)) {
+      if (keep_b_only) *out++ = y->data_;
+      y = Set::next_node(y);
+    } else {
+      if (keep_both) *out++ = x->data_;
+      x = Set::next_node(x);
+      y = Set::next_node(y);
+    }
   }
-  allocator_.destroy(node);
-  allocator_.deallocate(node, 1);
-  node = nullptr;
+  for (; keep_a_only && !done(a, x); x = Set::next_node(x)) *out++ = x->data_;
+  for (; keep_b_only && !done(b, y); y = Set::next_node(y)) *out++ = y->data_;
+  return out;
+}
+
+// Builds a new set (or map) from the result of op, balanced, by
+// assign_sorted.
+template <class Set>
+Set set_combined(const Set& a, const Set& b, set_operation op) {
+  vector<typename Set::value_type> buffer;
+  set_combine(a, b, op, std::back_inserter(buffer));
+  Set result;
+  result.assign_sorted(std::make_move_iterator(buffer.data()),
+                       std::make_move_iterator(buffer.data() + buffer.size()));
+  return result;
+}
+
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_union(const set<T, Ranked>& a, const set<T, Ranked>& b,
+                   OutputIt out) {
+  return set_combine(a, b, set_operation::kUnion, out);
+}
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_intersection(const set<T, Ranked>& a, const set<T, Ranked>& b,
+                          OutputIt out) {
+  return set_combine(a, b, set_operation::kIntersection, out);
+}
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_difference(const set<T, Ranked>& a, const set<T, Ranked>& b,
+                        OutputIt out) {
+  return set_combine(a, b, set_operation::kDifference, out);
+}
+template <class T, bool Ranked, class OutputIt>
+OutputIt set_symmetric_difference(const set<T, Ranked>& a,
+                                  const set<T, Ranked>& b, OutputIt out) {
+  return set_combine(a, b, set_operation::kSymmetricDifference, out);
 }
 
+template <class T, bool Ranked>
+set<T, Ranked> set_union(const set<T, Ranked>& a, const set<T, Ranked>& b) {
+  return set_combined(a, b, set_operation::kUnion);
+}
+template <class T, bool Ranked>
+set<T, Ranked> set_intersection(const set<T, Ranked>& a,
+                                const set<T, Ranked>& b) {
+  return set_combined(a, b, set_operation::kIntersection);
+}
+template <class T, bool Ranked>
+set<T, Ranked> set_difference(const set<T, Ranked>& a,
+                              const set<T, Ranked>& b) {
+  return set_combined(a, b, set_operation::kDifference);
+}
+template <class T, bool Ranked>
+set<T, Ranked> set_symmetric_difference(const set<T, Ranked>& a,
+                                        const set<T, Ranked>& b) {
+  return set_combined(a, b, set_operation::kSymmetricDifference);
+}
 };  // namespace myn
 
 #endif  // SRC_INCLUDE_SET_H_
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef SRC_INCLUDE_SPSC_QUEUE_H_
+#define SRC_INCLUDE_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace myn {
+// Bounded wait-free queue between exactly one producer thread and one
+// consumer thread. Each side owns one index (the producer tail_, the
+// consumer head_) on its own cache line and keeps a private copy of the
+// other side's index, which it refreshes only when the copy says the ring
+// is full (or empty). In steady state an operation therefore touches no
+// cache line the other thread writes, except the slot itself.
+//
+// push_n/pop_n move a batch and publish the index once for all of it.
+template <typename T>
+class spsc_queue {
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+  // capacity is rounded up to a power of two.
+  explicit spsc_queue(size_type capacity) {
+    size_type rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+    data_ = traits::allocate(alloc_, rounded);
+    mask_ = rounded - 1;
+  }
+  spsc_queue(const spsc_queue &) = delete;
+  spsc_queue &operator=(const spsc_queue &) = delete;
+  ~spsc_queue() {
+    size_type tail = tail_.load(std::memory_order_relaxed);
+    for (size_type i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+      traits::destroy(alloc_, data_ + (i & mask_));
+    }
+    traits::deallocate(alloc_, data_, mask_ + 1);
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+  // Snapshots when called while the other side is running.
+  size_type size() const noexcept {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+  bool empty() const noexcept { return size() == 0; }
+
+  // Producer side. Return false (and leave value alone) if the ring is
+  // full.
+  bool try_push(const_reference value) { return try_emplace(value); }
+  bool try_push(value_type &&value) { return try_emplace(std::move(value)); }
+  template <typename... Args>
+  bool try_emplace(Args &&...args);
+  // Pushes up to n elements from first; returns how many fit.
+  template <class InputIt>
+  size_type push_n(InputIt first, size_type n);
+
+  // Consumer side. Return false if the ring is empty.
+  bool try_pop(reference value);
+  // Pops up to n elements into out; returns how many there were.
+  template <class OutputIt>
+  size_type pop_n(OutputIt out, size_type n);
+
+ private:
+  using allocator_type = std::allocator<T>;
+  using traits = std::allocator_traits<allocator_type>;
+
+  // Free slots as seen by the producer, refreshing its copy of head_ only
+  // when fewer than wanted look free.
+  size_type free_slots(size_type tail, size_type wanted) {
+    size_type free = capacity() - (tail - cached_head_);
+    if (free < wanted) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      free = capacity() - (tail - cached_head_);
+    }
+    return free;
+  }
+  // Filled slots as seen by the consumer, likewise.
+  size_type filled_slots(size_type head, size_type wanted) {
+    size_type filled = cached_tail_ - head;
+    if (filled < wanted) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      filled = cached_tail_ - head;
+    }
+    return filled;
+  }
+
+  // Read-only after construction.
+  allocator_type alloc_;
+  T *data_;
+  size_type mask_;
+
+  // Consumer line.
+  alignas(64) std::atomic<size_type> head_{0};
+  size_type cached_tail_ = 0;
+
+  // Producer line.
+  alignas(64) std::atomic<size_type> tail_{0};
+  size_type cached_head_ = 0;
+
+  // Keeps the producer line from sharing with whatever follows the queue.
+  alignas(64) char padding_[1] = {};
+};
+
+template <typename T>
+template <typename... Args>
+bool spsc_queue<T>::try_emplace(Args &&...args) {
+  size_type tail = tail_.load(std::memory_order_relaxed);
+  if (free_slots(tail, 1) == 0) return false;
+  traits::construct(alloc_, data_ + (tail & mask_),
+                    std::forward<Args>(args)...);
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+template <class InputIt>
+typename spsc_queue<T>::size_type spsc_queue<T>::push_n(InputIt first,
+                                                       size_type n) {
+  size_type tail = tail_.load(std::memory_order_relaxed);
+  size_type free = free_slots(tail, n);
+  if (n > free) n = free;
+  for (size_type i = 0; i < n; ++i, ++first) {
+    traits::construct(alloc_, data_ + ((tail + i) & mask_), *first);
+  }
+  tail_.store(tail + n, std::memory_order_release);
+  return n;
+}
+
+template <typename T>
+bool spsc_queue<T>::try_pop(reference value) {
+  size_type head = head_.load(std::memory_order_relaxed);
+  if (filled_slots(head, 1) == 0) return false;
+  T *slot = data_ + (head & mask_);
+  value = std::move(*slot);
+  traits::destroy(alloc_, slot);
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+template <class OutputIt>
+typename spsc_queue<T>::size_type spsc_queue<T>::pop_n(OutputIt out,
+                                                      size_type n) {
+  size_type head = head_.load(std::memory_order_relaxed);
+  size_type filled = filled_slots(head, n);
+  if (n > filled) n = filled;
+  for (size_type i = 0; i < n; ++i, ++out) {
+    T *slot = data_ + ((head + i) & mask_);
+    *out = std::move(*slot);
+    traits::destroy(alloc_, slot);
+  }
+  head_.store(head + n, std::memory_order_release);
+  return n;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_SPSC_QUEUE_H_
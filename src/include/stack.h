@@ -1,42 +1,39 @@
 #ifndef SRC_INCLUDE_STACK_H_
 #define SRC_INCLUDE_STACK_H_
 
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.h"
+
 namespace myn {
-template <typename T>
+// LIFO adapter over any container with back, push_back, emplace_back and
+// pop_back. The default myn::vector keeps the elements in one buffer, so
+// push and pop only allocate when the buffer grows and a copy is a single
+// buffer copy; myn::list gives stable element addresses instead.
+template <typename T, class Container = vector<T>>
 class stack {
  public:
+  using container_type = Container;
   using value_type = T;
   using reference = T&;
   using const_reference = const T&;
   using size_type = size_t;
 
-  stack() noexcept {}
+  stack() {}
+  explicit stack(const container_type& c) : c_(c) {}
+  explicit stack(container_type&& c) : c_(std::move(c)) {}
 
-  stack(std::initializer_list<value_type> const& items) noexcept {
-    for (const auto item : items) {
+  stack(std::initializer_list<value_type> const& items) {
+    for (const auto& item : items) {
       push(item);
     }
   }
 
-  stack(const stack& other) {
-    Node* current = other.top_;
-    stack temp;
-    while (current) {
-      temp.push(current->value);
-      current = current->next;
-    }
-    while (!temp.empty()) {
-      push(temp.top());
-      temp.pop();
-    }
-  }
-
-  stack(stack&& other) noexcept : top_(other.top_), size_(other.size_) {
-    other.top_ = nullptr;
-    other.size_ = 0;
-  }
-
-  ~stack() { delete_stack(); }
+  stack(const stack& other) = default;
+  stack(stack&& other) noexcept = default;
+  ~stack() = default;
 
   stack& operator=(const stack& other) {
     if (this != &other) {
@@ -45,53 +42,33 @@ class stack {
     }
     return *this;
   }
+  stack& operator=(stack&& other) noexcept = default;
 
-  stack& operator=(stack&& other) noexcept {
-    if (this != &other) {
-      delete_stack();
-      top_ = other.top_;
-      size_ = other.size_;
-      other.top_ = nullptr;
-      other.size_ = 0;
-    }
-    return *this;
+  reference top() {
+    check_not_empty();
+    return c_.back();
   }
-
   const_reference top() const {
-    if (empty()) {
-      throw std::logic_error("stack is empty");
-    }
-    return top_->value;
+    check_not_empty();
+    return c_.back();
   }
 
-  bool empty() const noexcept { return size_ == 0; }
-  size_type size() const noexcept { return size_; }
+  bool empty() const noexcept { return c_.size() == 0; }
+  size_type size() const noexcept { return c_.size(); }
 
-  void push(const_reference value) noexcept {
-    Node* new_node = new Node(value);
-    if (empty()) {
-      top_ = new_node;
-    } else {
-      new_node->next = top_;
-      top_ = new_node;
-    }
-    ++size_;
+  void push(const_reference value) { c_.push_back(value); }
+  void push(value_type&& value) { c_.push_back(std::move(value)); }
+  template <typename... Args>
+  reference emplace(Args&&... args) {
+    return c_.emplace_back(std::forward<Args>(args)...);
   }
 
   void pop() {
-    if (empty()) {
-      throw std::logic_error("stack is empty");
-    }
-    Node* old_top = top_;
-    top_ = top_->next;
-    delete old_top;
-    --size_;
+    check_not_empty();
+    c_.pop_back();
   }
 
-  void swap(stack& other) noexcept {
-    std::swap(top_, other.top_);
-    std::swap(size_, other.size_);
-  }
+  void swap(stack& other) noexcept { c_.swap(other.c_); }
 
   template <typename... Args>
   void insert_many_front(Args&&... args) {
@@ -99,19 +76,11 @@ class stack {
   }
 
  private:
-  struct Node {
-    value_type value;
-    Node* next;
-
-    Node(value_type val) : value(val), next(nullptr) {}
-  };
+  container_type c_;
 
-  Node* top_ = nullptr;
-  size_type size_ = 0;
-
-  void delete_stack() {
-    while (!empty()) {
-      pop();
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("stack is empty");
     }
   }
 };
@@ -0,0 +1,213 @@
+#ifndef SRC_INCLUDE_THREAD_POOL_H_
+#define SRC_INCLUDE_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "queue.h"
+#include "vector.h"
+#include "work_stealing_deque.h"
+
+namespace myn {
+// Work-stealing thread pool. Every worker owns a work_stealing_deque: tasks
+// a worker submits go to the bottom of its own deque and it runs them LIFO,
+// while idle workers steal from the top of the others. Tasks submitted from
+// outside the pool go through one shared queue. Idle workers sleep.
+//
+// parallel_for is fork-join: it splits its range in halves, hands one half
+// to the pool and keeps the other, and until every piece has finished the
+// calling thread runs pool tasks instead of blocking. It may therefore be
+// nested, e.g. called from inside a task or another parallel_for.
+//
+// Tasks must not throw.
+class thread_pool {
+ public:
+  using size_type = size_t;
+
+  explicit thread_pool(size_type threads = std::thread::hardware_concurrency())
+      : deques_(new work_stealing_deque<Task *>[threads ? threads : 1]),
+        size_(threads ? threads : 1) {
+    workers_.reserve(size_);
+    for (size_type i = 0; i < size_; ++i) {
+      workers_.emplace_back(&thread_pool::worker_loop, this, i);
+    }
+  }
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  // Finishes every submitted task, then joins the workers.
+  ~thread_pool() {
+    wait();
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (size_type i = 0; i < size_; ++i) workers_[i].join();
+  }
+
+  size_type size() const noexcept { return size_; }
+
+  template <class F>
+  void submit(F &&task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    push(new Task{std::function<void()>(std::forward<F>(task)), &pending_});
+  }
+
+  // Blocks until every task passed to submit() has finished. Must not be
+  // called from inside a task: that task itself would never finish.
+  void wait() {
+    std::unique_lock<std::mutex> lock(done_mutex_);
+    done_.wait(lock, [this] {
+      return pending_.load(std::memory_order_acquire) == 0;
+    });
+  }
+
+  // Calls body(lo, hi) on disjoint subranges of [first, last) of at most
+  // grain indices each, in parallel, and returns once all of them have.
+  template <class Index, class F>
+  void parallel_for(Index first, Index last, Index grain, F &&body) {
+    if (!(first < last)) return;
+    if (grain < Index(1)) grain = Index(1);
+    std::atomic<size_type> children{0};
+    split(first, last, grain, body, children);
+    while (children.load(std::memory_order_acquire) != 0) {
+      if (!run_one(worker_index())) std::this_thread::yield();
+    }
+  }
+
+ private:
+  struct Task {
+    std::function<void()> run_;
+    std::atomic<size_type> *counter_;
+  };
+
+  static constexpr size_type kNotWorker = static_cast<size_type>(-1);
+
+  // Which worker of which pool the calling thread is.
+  struct WorkerId {
+    const thread_pool *pool_ = nullptr;
+    size_type index_ = kNotWorker;
+  };
+  static WorkerId &current_worker() {
+    thread_local WorkerId id;
+    return id;
+  }
+  size_type worker_index() const {
+    const WorkerId &id = current_worker();
+    return id.pool_ == this ? id.index_ : kNotWorker;
+  }
+
+  // Runs body on [first, last), first handing the upper halves to the pool
+  // as children counted in children.
+  template <class Index, class F>
+  void split(Index first, Index last, Index grain, F &body,
+             std::atomic<size_type> &children) {
+    while (grain < last - first) {
+      Index middle = first + (last - first) / 2;
+      children.fetch_add(1, std::memory_order_relaxed);
+      push(new Task{[this, middle, last, grain, &body, &children] {
+                      split(middle, last, grain, body, children);
+                    },
+                    &children});
+      last = middle;
+    }
+    body(first, last);
+  }
+
+  // Counts the task before publishing it: the thief that takes it
+  // synchronizes with the publication, so its decrement in run_one always
+  // follows this increment and queued_ never wraps below zero. A sleeper
+  // that sees the count early just retries until the task is visible.
+  void push(Task *task) {
+    queued_.fetch_add(1, std::memory_order_seq_cst);
+    size_type index = worker_index();
+    if (index != kNotWorker) {
+      deques_[index].push(task);
+    } else {
+      std::lock_guard<std::mutex> lock(injected_mutex_);
+      injected_.push(task);
+    }
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      wake_.notify_one();
+    }
+  }
+
+  // Runs one task from the caller's own deque, another worker's deque or
+  // the shared queue. Returns false if it found none.
+  bool run_one(size_type index) {
+    Task *task = nullptr;
+    if (index == kNotWorker || !deques_[index].pop(task)) {
+      if (!steal(index, task) && !pop_injected(task)) return false;
+    }
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    task->run_();
+    std::atomic<size_type> *counter = task->counter_;
+    delete task;
+    if (counter->fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+        counter == &pending_) {
+      std::lock_guard<std::mutex> lock(done_mutex_);
+      done_.notify_all();
+    }
+    return true;
+  }
+
+  bool steal(size_type thief, Task *&task) {
+    size_type start = thief == kNotWorker ? 0 : thief + 1;
+    for (size_type i = 0; i < size_; ++i) {
+      size_type victim = (start + i) % size_;
+      if (victim != thief && deques_[victim].steal(task)) return true;
+    }
+    return false;
+  }
+
+  bool pop_injected(Task *&task) {
+    std::lock_guard<std::mutex> lock(injected_mutex_);
+    if (injected_.empty()) return false;
+    task = injected_.front();
+    injected_.pop();
+    return true;
+  }
+
+  void worker_loop(size_type index) {
+    current_worker() = WorkerId{this, index};
+    while (true) {
+      if (run_one(index)) continue;
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      wake_.wait(lock, [this] {
+        return stopping_ || queued_.load(std::memory_order_seq_cst) != 0;
+      });
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+      if (stopping_ && queued_.load() == 0) return;
+    }
+  }
+
+  std::unique_ptr<work_stealing_deque<Task *>[]> deques_;
+  size_type size_;
+  vector<std::thread> workers_;
+
+  std::mutex injected_mutex_;
+  queue<Task *> injected_;
+
+  // Tasks sitting in a deque or the shared queue, for the sleepers.
+  std::atomic<size_type> queued_{0};
+  std::atomic<size_type> sleepers_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+
+  // Tasks passed to submit() that have not finished yet.
+  std::atomic<size_type> pending_{0};
+  std::mutex done_mutex_;
+  std::condition_variable done_;
+};
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_THREAD_POOL_H_
@@ -0,0 +1,367 @@
+#ifndef SRC_INCLUDE_UNROLLED_LIST_H_
+#define SRC_INCLUDE_UNROLLED_LIST_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace myn {
+// Elements per node: about 512 bytes of payload, at least 4 elements.
+template <class T>
+constexpr std::size_t unrolled_list_node_capacity() {
+  return 512 / sizeof(T) > 4 ? 512 / sizeof(T) : 4;
+}
+
+// Doubly-linked list of small arrays. Each node holds up to N elements
+// contiguously, so a traversal takes one cache miss per node instead of one
+// per element. Inserting into a full node splits it in two. An erase that
+// leaves a node under half full merges it with a neighbour when both fit in
+// one node, and otherwise borrows an element from that neighbour, so insert
+// and erase near an iterator stay O(N). Unlike myn::list, insert and erase
+// invalidate iterators into the touched nodes; use the returned iterator.
+template <class T, std::size_t N = unrolled_list_node_capacity<T>()>
+class unrolled_list {
+  static_assert(N >= 2, "unrolled_list nodes must hold at least 2 elements");
+
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = size_t;
+
+ private:
+  struct Node {
+    Node() : prev_(nullptr), next_(nullptr), count_(0) {}
+    T *data() { return std::launder(reinterpret_cast<T *>(storage_)); }
+    Node *prev_;
+    Node *next_;
+    size_type count_;
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+  };
+
+ public:
+  template <typename Value>
+  class UnrolledIterator {
+   public:
+    using value_type = T;
+    using reference = Value &;
+    using pointer = Value *;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    UnrolledIterator() = default;
+    UnrolledIterator(Node *node, size_type index)
+        : node_(node), index_(index) {}
+    // iterator converts to const_iterator
+    UnrolledIterator(const UnrolledIterator<T> &other)
+        : node_(other.node_), index_(other.index_) {}
+    UnrolledIterator &operator=(const UnrolledIterator &other) = default;
+
+    reference operator*() const { return node_->data()[index_]; }
+    pointer operator->() const { return &node_->data()[index_]; }
+
+    UnrolledIterator &operator++() {
+      if (++index_ == node_->count_ && node_->next_ != nullptr) {
+        node_ = node_->next_;
+        index_ = 0;
+      }
+      return *this;
+    }
+    UnrolledIterator operator++(int) {
+      UnrolledIterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+    UnrolledIterator &operator--() {
+      if (index_ == 0) {
+        node_ = node_->prev_;
+        index_ = node_->count_;
+      }
+      --index_;
+      return *this;
+    }
+    UnrolledIterator operator--(int) {
+      UnrolledIterator tmp(*this);
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const UnrolledIterator &other) const {
+      return node_ == other.node_ && index_ == other.index_;
+    }
+    bool operator!=(const UnrolledIterator &other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class unrolled_list;
+    template <typename>
+    friend class UnrolledIterator;
+    Node *node_ = nullptr;
+    size_type index_ = 0;
+  };
+  using iterator = UnrolledIterator<T>;
+  using const_iterator = UnrolledIterator<const T>;
+
+  unrolled_list() noexcept {}
+  unrolled_list(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) push_back(item);
+  }
+  unrolled_list(const unrolled_list &other) {
+    for (auto it = other.cbegin(); it != other.cend(); ++it) push_back(*it);
+  }
+  unrolled_list(unrolled_list &&other) noexcept { swap(other); }
+  ~unrolled_list() { clear(); }
+
+  unrolled_list &operator=(const unrolled_list &other) {
+    if (this != &other) {
+      unrolled_list temp(other);
+      swap(temp);
+    }
+    return *this;
+  }
+  unrolled_list &operator=(unrolled_list &&other) noexcept {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // The end iterator is one past the last element of the tail node, so the
+  // only node-less iterator is begin() == end() of an empty list.
+  iterator begin() noexcept { return iterator(head_, 0); }
+  iterator end() noexcept { return iterator(tail_, tail_ ? tail_->count_ : 0); }
+  const_iterator cbegin() const noexcept { return const_iterator(head_, 0); }
+  const_iterator cend() const noexcept {
+    return const_iterator(tail_, tail_ ? tail_->count_ : 0);
+  }
+
+  reference front() {
+    check_not_empty();
+    return head_->data()[0];
+  }
+  reference back() {
+    check_not_empty();
+    return tail_->data()[tail_->count_ - 1];
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type max_size() const noexcept {
+    return std::allocator_traits<std::allocator<Node>>::max_size(allocator_) *
+           N;
+  }
+
+  void clear() noexcept;
+  iterator insert(iterator pos, const_reference value) {
+    return emplace(pos, value);
+  }
+  iterator insert(iterator pos, value_type &&value) {
+    return emplace(pos, std::move(value));
+  }
+  template <typename... Args>
+  iterator emplace(iterator pos, Args &&...args);
+  iterator erase(iterator pos);
+  void push_back(const_reference value) { emplace(end(), value); }
+  void push_back(value_type &&value) { emplace(end(), std::move(value)); }
+  void push_front(const_reference value) { emplace(begin(), value); }
+  void push_front(value_type &&value) { emplace(begin(), std::move(value)); }
+  void pop_back() {
+    check_not_empty();
+    erase(iterator(tail_, tail_->count_ - 1));
+  }
+  void pop_front() {
+    check_not_empty();
+    erase(begin());
+  }
+  void swap(unrolled_list &other) noexcept {
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  Node *head_ = nullptr;
+  Node *tail_ = nullptr;
+  size_type size_ = 0;
+  std::allocator<Node> allocator_;
+
+  Node *create_node(Node *prev, Node *next);
+  void destroy_node(Node *node) noexcept;
+  // Moves the elements [from, node->count_) of node to the front of the
+  // empty node dest.
+  static void move_tail(Node *node, size_type from, Node *dest);
+  // Appends the elements of node->next_ to node and frees the next node.
+  void merge_next(Node *node);
+  void check_not_empty() const {
+    if (empty()) {
+      throw std::logic_error("unrolled_list is empty");
+    }
+  }
+};
+
+template <class T, std::size_t N>
+void unrolled_list<T, N>::clear() noexcept {
+  while (head_ != nullptr) {
+    Node *next = head_->next_;
+    std::destroy_n(head_->data(), head_->count_);
+    destroy_node(head_);
+    head_ = next;
+  }
+  tail_ = nullptr;
+  size_ = 0;
+}
+
+template <class T, std::size_t N>
+template <typename... Args>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::emplace(
+    iterator pos, Args &&...args) {
+  Node *node = pos.node_;
+  size_type index = pos.index_;
+  if (node == nullptr) {
+    node = head_ = tail_ = create_node(nullptr, nullptr);
+  } else if (node->count_ == N) {
+    if (index == N) {
+      // Appending past a full node: start a fresh one rather than leaving
+      // two half-empty nodes behind, so push_back fills nodes completely.
+      node = create_node(node, node->next_);
+      index = 0;
+    } else if (index == 0 && (node->prev_ == nullptr ||
+                              node->prev_->count_ == N)) {
+      node = create_node(node->prev_, node);
+    } else if (index == 0) {
+      node = node->prev_;
+      index = node->count_;
+    } else {
+      Node *half = create_node(node, node->next_);
+      move_tail(node, N / 2, half);
+      if (index > node->count_) {
+        index -= node->count_;
+        node = half;
+      }
+    }
+  }
+
+  T *data = node->data();
+  if (index == node->count_) {
+    ::new (static_cast<void *>(data + index)) T(std::forward<Args>(args)...);
+  } else {
+    T value(std::forward<Args>(args)...);
+    ::new (static_cast<void *>(data + node->count_))
+        T(std::move(data[node->count_ - 1]));
+    std::move_backward(data + index, data + node->count_ - 1,
+                       data + node->count_);
+    data[index] = std::move(value);
+  }
+  ++node->count_;
+  ++size_;
+  return iterator(node, index);
+}
+
+template <class T, std::size_t N>
+typename unrolled_list<T, N>::iterator unrolled_list<T, N>::erase(
+    iterator pos) {
+  Node *node = pos.node_;
+  size_type index = pos.index_;
+  T *data = node->data();
+  std::move(data + index + 1, data + node->count_, data + index);
+  std::destroy_at(data + node->count_ - 1);
+  --node->count_;
+  --size_;
+
+  if (node->count_ == 0) {
+    Node *next = node->next_;
+    Node *prev = node->prev_;
+    (prev ? prev->next_ : head_) = next;
+    (next ? next->prev_ : tail_) = prev;
+    destroy_node(node);
+    if (next != nullptr) return iterator(next, 0);
+    return end();
+  }
+
+  // Under half full: merge with a neighbour if both fit in one node, else
+  // borrow the neighbour's nearest element. index follows the element after
+  // the erased one.
+  if (node->count_ < N / 2) {
+    Node *next = node->next_;
+    Node *prev = node->prev_;
+    if (next != nullptr && node->count_ + next->count_ <= N) {
+      merge_next(node);
+    } else if (prev != nullptr && prev->count_ + node->count_ <= N) {
+      index += prev->count_;
+      node = prev;
+      merge_next(node);
+    } else if (next != nullptr) {
+      T *src = next->data();
+      ::new (static_cast<void *>(node->data() + node->count_))
+          T(std::move(src[0]));
+      std::move(src + 1, src + next->count_, src);
+      std::destroy_at(src + next->count_ - 1);
+      ++node->count_;
+      --next->count_;
+    } else if (prev != nullptr) {
+      T *dest = node->data();
+      ::new (static_cast<void *>(dest + node->count_))
+          T(std::move(dest[node->count_ - 1]));
+      std::move_backward(dest, dest + node->count_ - 1,
+                         dest + node->count_);
+      dest[0] = std::move(prev->data()[prev->count_ - 1]);
+      std::destroy_at(prev->data() + prev->count_ - 1);
+      ++node->count_;
+      --prev->count_;
+      ++index;
+    }
+  }
+  if (index == node->count_ && node->next_ != nullptr) {
+    return iterator(node->next_, 0);
+  }
+  return iterator(node, index);
+}
+
+template <class T, std::size_t N>
+typename unrolled_list<T, N>::Node *unrolled_list<T, N>::create_node(
+    Node *prev, Node *next) {
+  Node *node = allocator_.allocate(1);
+  std::allocator_traits<std::allocator<Node>>::construct(allocator_, node);
+  node->prev_ = prev;
+  node->next_ = next;
+  (prev ? prev->next_ : head_) = node;
+  (next ? next->prev_ : tail_) = node;
+  return node;
+}
+
+template <class T, std::size_t N>
+void unrolled_list<T, N>::destroy_node(Node *node) noexcept {
+  std::allocator_traits<std::allocator<Node>>::destroy(allocator_, node);
+  allocator_.deallocate(node, 1);
+}
+
+template <class T, std::size_t N>
+void unrolled_list<T, N>::merge_next(Node *node) {
+  Node *next = node->next_;
+  std::uninitialized_move_n(next->data(), next->count_,
+                            node->data() + node->count_);
+  std::destroy_n(next->data(), next->count_);
+  node->count_ += next->count_;
+  next->count_ = 0;
+  node->next_ = next->next_;
+  (node->next_ ? node->next_->prev_ : tail_) = node;
+  destroy_node(next);
+}
+
+template <class T, std::size_t N>
+void unrolled_list<T, N>::move_tail(Node *node, size_type from, Node *dest) {
+  size_type count = node->count_ - from;
+  std::uninitialized_move_n(node->data() + from, count, dest->data());
+  std::destroy_n(node->data() + from, count);
+  dest->count_ = count;
+  node->count_ = from;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_UNROLLED_LIST_H_
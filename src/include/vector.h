@@ -2,7 +2,9 @@
 #define SRC_INCLUDE_VECTOR_H_
 
 #include <initializer_list>
+#include <limits>
 #include <memory>
+#include <utility>
 
 #include "random_access_iterator.h"
 
@@ -22,7 +24,7 @@ class vector {
   explicit vector(size_type n)
       : data_(alloc_.allocate(n)), size_(0), capacity_(n) {
     for (size_type i = 0; i < n; ++i) {
-      data_[i] = T();
+      alloc_.construct(&data_[i]);
       ++size_;
     }
   };
@@ -36,26 +38,30 @@ class vector {
       : data_(alloc_.allocate(v.capacity_)),
         size_(v.size_),
         capacity_(v.capacity_) {
-    for (size_type i = 0; i < v.size_; ++i) data_[i] = v.data_[i];
+    std::uninitialized_copy(v.data_, v.data_ + v.size_, data_);
   }
-  vector(vector &&v) : data_(v.size_), size_(v.size_), capacity_(v.capacity_) {
+  vector(vector &&v) noexcept
+      : data_(v.data_), size_(v.size_), capacity_(v.capacity_) {
     v.data_ = 0;
     v.size_ = 0;
     v.capacity_ = 0;
   };
-  ~vector() { alloc_.deallocate(data_, capacity_); };
+  ~vector() {
+    clear();
+    alloc_.deallocate(data_, capacity_);
+  };
 
-  vector operator=(vector &&v) {
+  vector &operator=(vector &&v) noexcept {
     if (this == &v) return *this;
-    if (v.size_ <= capacity_) {
-      for (size_type i = 0; i < v.size_; ++i) data_[i] = v.data_[i];
-      return *this;
-    }
-    resize(v.size_);
-    for (auto i = 0; i < v.size_; ++i) data_[i] = v.data_[i];
+    clear();
+    alloc_.deallocate(data_, capacity_);
+    data_ = v.data_;
+    size_ = v.size_;
+    capacity_ = v.capacity_;
     v.data_ = nullptr;
     v.size_ = 0;
     v.capacity_ = 0;
+    v.invalidate_iterators();
     return *this;
   };
 
@@ -71,17 +77,23 @@ class vector {
     }
     return data_[0];
   };
-  const_reference back() {
+  reference back() {
+    if (size_ == 0) {
+      throw std::out_of_range("Vector is empty");
+    }
+    return data_[size_ - 1];
+  };
+  const_reference back() const {
     if (size_ == 0) {
       throw std::out_of_range("Vector is empty");
     }
-    return data_[size_];
+    return data_[size_ - 1];
   };
   T *data() noexcept { return data_; };
-  iterator begin() { return iterator(data_); };
-  iterator end() { return iterator(data_ + size()); };
-  const_iterator cbegin() const { return const_iterator(data_); };
-  const_iterator cend() const { return const_iterator(data_ + size()); };
+  iterator begin() { return make_iterator(data_); };
+  iterator end() { return make_iterator(data_ + size()); };
+  const_iterator cbegin() const { return make_const_iterator(data_); };
+  const_iterator cend() const { return make_const_iterator(data_ + size()); };
 
   bool empty() const noexcept { return (cbegin() == cend()) ? true : false; };
   size_type size() const noexcept { return size_; };
@@ -91,11 +103,14 @@ class vector {
   void reserve(size_type size) {
     if (size <= capacity_) return;
     value_type *ptr = alloc_.allocate(size);
-    for (size_type i = 0; i < size_; ++i) alloc_.construct(&ptr[i], data_[i]);
+    for (size_type i = 0; i < size_; ++i) {
+      alloc_.construct(&ptr[i], std::move_if_noexcept(data_[i]));
+    }
     for (size_type i = 0; i < size_; ++i) alloc_.destroy(&data_[i]);
     alloc_.deallocate(data_, capacity_);
     data_ = ptr;
     capacity_ = size;
+    invalidate_iterators();
   };
 
   size_type capacity() const noexcept { return capacity_; };
@@ -109,11 +124,13 @@ class vector {
       alloc_.deallocate(data_, capacity_);
       data_ = new_data;
       capacity_ = size_;
+      invalidate_iterators();
     }
   };
   void clear() noexcept {
     for (size_type i = 0; i < size_; ++i) alloc_.destroy(&data_[i]);
     size_ = 0;
+    invalidate_iterators();
   };
 
   iterator insert(iterator pos, const_reference value) {
@@ -127,7 +144,8 @@ class vector {
     }
     data_[index] = value;
     ++size_;
-    return iterator(data_ + index);
+    invalidate_iterators();
+    return make_iterator(data_ + index);
   };
 
   void erase(iterator pos) {
@@ -141,35 +159,49 @@ class vector {
     }
     --size_;
     alloc_.destroy(&data_[size_]);
+    invalidate_iterators();
   };
 
-  void push_back(const_reference value) {
-    if (capacity_ == 0) {
-      reserve(4);
-    } else if (size_ == capacity_) {
-      reserve(2 * capacity_);
+  void push_back(const_reference value) { emplace_back(value); };
+  void push_back(value_type &&value) { emplace_back(std::move(value)); };
+  template <typename... Args>
+  reference emplace_back(Args &&...args) {
+    if (size_ == capacity_) {
+      // The arguments may refer into this vector, so build the element
+      // before the storage moves.
+      value_type value(std::forward<Args>(args)...);
+      reserve(capacity_ ? 2 * capacity_ : 4);
+      alloc_.construct(&data_[size_], std::move(value));
+    } else {
+      alloc_.construct(&data_[size_], std::forward<Args>(args)...);
     }
-    alloc_.construct(&data_[size_], value);
-    ++size_;
+    return data_[size_++];
+  };
+  void pop_back() {
+    --size_;
+    alloc_.destroy(&data_[size_]);
+    invalidate_iterators();
   };
-  void pop_back() { resize(size_ - 1); };
   void swap(vector &other) noexcept(
       std::allocator_traits<A>::propagate_on_container_swap::value ||
       std::allocator_traits<A>::is_always_equal::value) {
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
+    invalidate_iterators();
+    other.invalidate_iterators();
   };
 
   void resize(size_type newsize) {
-    if (newsize == capacity_) return;
-    if (newsize < capacity_) {
+    if (newsize == size_) return;
+    if (newsize < size_) {
       for (size_type i = newsize; i < size_; ++i) alloc_.destroy(&data_[i]);
     } else {
       reserve(newsize);
       for (size_type i = size_; i < newsize; ++i) alloc_.construct(&data_[i]);
     }
     size_ = newsize;
+    invalidate_iterators();
   };
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args &&...args) {
@@ -180,12 +212,12 @@ class vector {
       reserve(size_ + numArgs);
     }
     if (index < size_) {
-      std::copy_backward(begin() + index, end(),
-                         end() + difference_type(numArgs));
+      std::copy_backward(data_ + index, data_ + size_, data_ + size_ + numArgs);
     }
-    std::copy(temp, temp + numArgs, begin() + index);
+    std::copy(temp, temp + numArgs, data_ + index);
     size_ += numArgs;
-    return begin() + index;
+    invalidate_iterators();
+    return make_iterator(data_ + index);
   };
 
   template <typename... Args>
@@ -195,7 +227,7 @@ class vector {
     if (size_ + numArgs > capacity_) {
       reserve(size_ + numArgs);
     }
-    std::copy(temp, temp + numArgs, end());
+    std::copy(temp, temp + numArgs, data_ + size_);
     size_ += numArgs;
   };
 
@@ -204,6 +236,29 @@ class vector {
   value_type *data_;
   size_type size_;
   size_type capacity_;
+#ifdef MYN_CHECKED_ITERATORS
+  iterator_guard<T> guard_{&data_, &size_};
+#endif
+
+  iterator make_iterator(value_type *ptr) {
+#ifdef MYN_CHECKED_ITERATORS
+    return iterator(ptr, &guard_);
+#else
+    return iterator(ptr);
+#endif
+  }
+  const_iterator make_const_iterator(const value_type *ptr) const {
+#ifdef MYN_CHECKED_ITERATORS
+    return const_iterator(ptr, &guard_);
+#else
+    return const_iterator(ptr);
+#endif
+  }
+  void invalidate_iterators() noexcept {
+#ifdef MYN_CHECKED_ITERATORS
+    guard_.invalidate();
+#endif
+  }
 };
 }  // namespace myn
 
@@ -0,0 +1,143 @@
+#ifndef SRC_INCLUDE_WORK_STEALING_DEQUE_H_
+#define SRC_INCLUDE_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace myn {
+// Chase-Lev work-stealing deque, with the C11 memory orders of Le, Pop,
+// Cohen and Zappa Nardelli. One owner thread pushes and pops at the bottom
+// (LIFO, so it keeps working on the data it just touched); any number of
+// thieves steal from the top (FIFO, so they take the oldest and usually
+// largest piece of work). The buffer doubles when full; a replaced buffer
+// may still be read by a thief, so it is kept until the deque is destroyed.
+template <class T>
+class work_stealing_deque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "work_stealing_deque elements are copied with atomic loads");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // capacity is rounded up to a power of two.
+  explicit work_stealing_deque(size_type capacity = 64) {
+    size_type rounded = 1;
+    while (rounded < capacity) rounded <<= 1;
+    buffer_.store(new Buffer(rounded, nullptr), std::memory_order_relaxed);
+  }
+  work_stealing_deque(const work_stealing_deque &) = delete;
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+  ~work_stealing_deque() {
+    Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+    while (buffer != nullptr) {
+      Buffer *previous = buffer->previous_;
+      delete buffer;
+      buffer = previous;
+    }
+  }
+
+  // Snapshots; exact only on the owner while no thief is active.
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept {
+    std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+  }
+
+  // Owner only.
+  void push(value_type value);
+  // Owner only: takes the most recently pushed element.
+  bool pop(value_type &value);
+  // Any thread: takes the oldest element. Returns false if the deque is
+  // empty or another thread took that element first.
+  bool steal(value_type &value);
+
+ private:
+  struct Buffer {
+    Buffer(size_type capacity, Buffer *previous)
+        : mask_(capacity - 1),
+          slots_(new std::atomic<value_type>[capacity]),
+          previous_(previous) {}
+    size_type capacity() const { return mask_ + 1; }
+    value_type get(std::int64_t index) const {
+      return slots_[index & mask_].load(std::memory_order_relaxed);
+    }
+    void put(std::int64_t index, value_type value) {
+      slots_[index & mask_].store(value, std::memory_order_relaxed);
+    }
+    size_type mask_;
+    std::unique_ptr<std::atomic<value_type>[]> slots_;
+    Buffer *previous_;
+  };
+
+  Buffer *grow(Buffer *buffer, std::int64_t bottom, std::int64_t top) {
+    Buffer *bigger = new Buffer(buffer->capacity() * 2, buffer);
+    for (std::int64_t i = top; i < bottom; ++i) bigger->put(i, buffer->get(i));
+    buffer_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+  // top_ and bottom_ sit on separate cache lines: thieves only write top_.
+  alignas(64) std::atomic<std::int64_t> top_{0};
+  alignas(64) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Buffer *> buffer_{nullptr};
+};
+
+template <class T>
+void work_stealing_deque<T>::push(value_type value) {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  std::int64_t top = top_.load(std::memory_order_acquire);
+  Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+  if (bottom - top > static_cast<std::int64_t>(buffer->capacity()) - 1) {
+    buffer = grow(buffer, bottom, top);
+  }
+  buffer->put(bottom, value);
+  // A release store rather than the paper's release fence: same code on
+  // x86, and visible to ThreadSanitizer.
+  bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+template <class T>
+bool work_stealing_deque<T>::pop(value_type &value) {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return false;
+  }
+  value = buffer->get(bottom);
+  if (top == bottom) {
+    // Last element: race the thieves for it through top_.
+    bool won = top_.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return won;
+  }
+  return true;
+}
+
+template <class T>
+bool work_stealing_deque<T>::steal(value_type &value) {
+  std::int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) return false;
+  Buffer *buffer = buffer_.load(std::memory_order_acquire);
+  value_type stolen = buffer->get(top);
+  if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return false;
+  }
+  value = stolen;
+  return true;
+}
+}  // namespace myn
+
+#endif  // SRC_INCLUDE_WORK_STEALING_DEQUE_H_